@@ -68,6 +68,21 @@ public:
   // Calculate filter response at the given normalized frequency.
   complex_t response (double normalizedFrequency) const;
 
+  // Calculate filter response at numFrequencies normalized frequencies.
+  void response (const double* normalizedFrequencies,
+                 complex_t* out,
+                 int numFrequencies) const;
+
+  // Calculate only the magnitude of the response, which is cheaper.
+  void magnitudeResponse (const double* normalizedFrequencies,
+                          double* out,
+                          int numFrequencies) const;
+
+  // Calculate the group delay in samples.
+  void groupDelay (const double* normalizedFrequencies,
+                   double* out,
+                   int numFrequencies) const;
+
   std::vector<PoleZeroPair> getPoleZeros () const;
 
   double getA0 () const { return m_a0; }
@@ -124,6 +139,85 @@ public:
 
 //------------------------------------------------------------------------------
 
+/*
+ * Evaluates the frequency response of a chain of second order sections
+ * over an array of frequencies. The points are handled in fixed size
+ * chunks kept as separate arrays, so that the loops over each section
+ * vectorize. A uniformly spaced grid gets its sines and cosines from a
+ * rotation recurrence, re-seeded at the start of every chunk.
+ *
+ * The group delay is undefined at a zero on the unit circle, for example
+ * at Nyquist for a lowpass, and comes out as a non-finite value there.
+ *
+ */
+class ResponseEvaluator
+{
+public:
+  ResponseEvaluator (const double* normalizedFrequencies,
+                     int numFrequencies);
+
+  // Evaluate the chain. Only the outputs that are not null are calculated.
+  template <class StageType>
+  void evaluate (const StageType* stages,
+                 int numStages,
+                 complex_t* response,
+                 double* magnitude,
+                 double* groupDelay)
+  {
+    for (int start = 0; start < m_numFrequencies; start += chunkSize)
+    {
+      const int remaining = m_numFrequencies - start;
+      const int count = remaining < chunkSize ? remaining : chunkSize;
+
+      beginChunk (start, count, response != 0, magnitude != 0, groupDelay != 0);
+
+      for (int i = 0; i < numStages; ++i)
+        addSection (stages[i]);
+
+      endChunk (start, response, magnitude, groupDelay);
+    }
+  }
+
+private:
+  enum
+  {
+    chunkSize = 64
+  };
+
+  void beginChunk (int start, int count,
+                   bool wantResponse, bool wantMagnitude, bool wantGroupDelay);
+  void addSection (const BiquadBase& s);
+  void endChunk (int start,
+                 complex_t* response, double* magnitude, double* groupDelay);
+
+  const double* m_frequencies;
+  int m_numFrequencies;
+  bool m_isUniform;
+  double m_step;
+
+  int m_count;
+  bool m_wantResponse;
+  bool m_wantMagnitude;
+  bool m_wantGroupDelay;
+
+  // Angles of the current chunk
+  double m_cos1 [chunkSize];
+  double m_sin1 [chunkSize];
+  double m_cos2 [chunkSize];
+  double m_sin2 [chunkSize];
+
+  // Accumulated products and sums of the current chunk
+  double m_numRe [chunkSize];
+  double m_numIm [chunkSize];
+  double m_denRe [chunkSize];
+  double m_denIm [chunkSize];
+  double m_numMag [chunkSize];
+  double m_denMag [chunkSize];
+  double m_delay [chunkSize];
+};
+
+//------------------------------------------------------------------------------
+
 // Expresses a biquad as a pair of pole/zeros, with gain
 // values so that the coefficients can be reconstructed precisely.
 struct BiquadPoleState : PoleZeroPair
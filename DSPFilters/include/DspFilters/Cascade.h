@@ -79,6 +79,11 @@ public:
     {
     }
 
+    void resetDenormalPrevention ()
+    {
+      DenormalPrevention::resetAc ();
+    }
+
   protected:
     StateType* m_stateArray;
   };
@@ -104,7 +109,7 @@ public:
     return m_numStages;
   }
 
-  const Stage& operator[] (int index)
+  const Stage& operator[] (int index) const
   {
     assert (index >= 0 && index <= m_numStages);
     return m_stageArray[index];
@@ -114,6 +119,21 @@ public:
   // Calculate filter response at the given normalized frequency.
   complex_t response (double normalizedFrequency) const;
 
+  // Calculate filter response at numFrequencies normalized frequencies.
+  void response (const double* normalizedFrequencies,
+                 complex_t* out,
+                 int numFrequencies) const;
+
+  // Calculate only the magnitude of the response, which is cheaper.
+  void magnitudeResponse (const double* normalizedFrequencies,
+                          double* out,
+                          int numFrequencies) const;
+
+  // Calculate the group delay in samples.
+  void groupDelay (const double* normalizedFrequencies,
+                   double* out,
+                   int numFrequencies) const;
+
   std::vector<PoleZeroPair> getPoleZeros () const;
 
   // Process a block of samples in the given form
@@ -160,6 +180,7 @@ public:
       StateType* state = m_states;
       for (int i = MaxStages; --i >= 0; ++state)
         state->reset();
+      this->resetDenormalPrevention ();
     }
 
   private:
@@ -0,0 +1,132 @@
+/*******************************************************************************
+
+"A Collection of Useful C++ Classes for Digital Signal Processing"
+ By Vincent Falco
+
+Official project location:
+http://code.google.com/p/dspfilterscpp/
+
+See Documentation.cpp for contact information, notes, and bibliography.
+
+--------------------------------------------------------------------------------
+
+License: MIT License (http://www.opensource.org/licenses/mit-license.php)
+Copyright (c) 2009 by Vincent Falco
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+
+*******************************************************************************/
+
+
+#ifndef DSPFILTERS_CPUDISPATCH_H
+#define DSPFILTERS_CPUDISPATCH_H
+
+#include "DspFilters/Common.h"
+
+//
+// Architecture of the build
+//
+
+#if defined (__x86_64__) || defined (_M_X64) || defined (__i386__) || defined (_M_IX86)
+#  define DSPFILTERS_X86 1
+#  if defined (__SSE2__) || defined (_M_X64) || (defined (_M_IX86_FP) && _M_IX86_FP >= 2)
+#    define DSPFILTERS_SSE2 1
+#  endif
+#  if !defined (_MSC_VER) || _MSC_VER >= 1911
+#    define DSPFILTERS_AVX512 1
+#  endif
+#elif defined (__ARM_NEON) || defined (__ARM_NEON__)
+#  define DSPFILTERS_NEON 1
+#  if defined (__aarch64__) || defined (_M_ARM64)
+#    define DSPFILTERS_NEON_DOUBLE 1
+#  endif
+#endif
+
+//
+// Compile one function for an instruction set above the build's baseline.
+// It may only be called once CpuDispatch reports the set as selected.
+// MSVC emits any intrinsic without this, but doesn't vectorize loops for
+// the wider set either.
+//
+
+#if DSPFILTERS_X86 && (defined (__GNUC__) || defined (__clang__))
+#  define DSPFILTERS_TARGET_AVX2 __attribute__ ((target ("avx2")))
+#  define DSPFILTERS_TARGET_AVX512 __attribute__ ((target ("avx512f")))
+#else
+#  define DSPFILTERS_TARGET_AVX2
+#  define DSPFILTERS_TARGET_AVX512
+#endif
+
+namespace Dsp {
+
+/*
+ * Instruction set of the optimised kernels, chosen at run time.
+ *
+ * Builds target a baseline (SSE2 on x86, NEON on ARM) so that they run on
+ * every machine. Kernels that gain from wider vectors are compiled again
+ * for AVX2 and AVX-512, and the set they run with is picked once from what
+ * the CPU and the operating system support, rather than per call.
+ *
+ * select () detects the set, or takes the one forced for testing, and is
+ * meant to be called while preparing to play. get () is what the kernels
+ * read on every call; it is lock-free and selects on first use if
+ * nothing has yet. The vector sets give bit identical results for the
+ * same input, except in saturate, whose reciprocal estimate differs
+ * between sets by a few ulp. The reference templates also differ in the
+ * rounding of their fade ramps.
+ *
+ */
+
+class CpuDispatch
+{
+public:
+  enum InstructionSet
+  {
+    generic,      // the reference C++ templates
+    sse2,
+    avx2,
+    avx512,
+    neon,
+
+    numInstructionSets
+  };
+
+  // The best set this build and the machine it runs on support
+  static InstructionSet detect ();
+
+  static bool isSupported (InstructionSet set);
+
+  // Select the forced set if there is one, otherwise the detected one.
+  // Returns the selected set.
+  static InstructionSet select ();
+
+  // Force a set for testing, taking effect at the next select (). Returns
+  // false, changing nothing, if the set isn't supported here. Forcing
+  // numInstructionSets goes back to detection.
+  static bool force (InstructionSet set);
+
+  // The selected set
+  static InstructionSet get ();
+
+  static const char* getName (InstructionSet set);
+};
+
+}
+
+#endif
@@ -44,10 +44,17 @@ THE SOFTWARE.
 
 #include "DspFilters/Biquad.h"
 #include "DspFilters/Cascade.h"
+#include "DspFilters/CpuDispatch.h"
 #include "DspFilters/Filter.h"
+#include "DspFilters/FilterBank.h"
+#include "DspFilters/FixedCascade.h"
+#include "DspFilters/ParallelForm.h"
 #include "DspFilters/PoleFilter.h"
+#include "DspFilters/PrototypeCache.h"
 #include "DspFilters/SmoothedFilter.h"
 #include "DspFilters/State.h"
+#include "DspFilters/StateSpace.h"
+#include "DspFilters/StateVariable.h"
 #include "DspFilters/Utilities.h"
 
 #include "DspFilters/Bessel.h"
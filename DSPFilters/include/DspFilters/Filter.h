@@ -104,6 +104,20 @@ public:
  
   virtual complex_t response (double normalizedFrequency) const = 0;
 
+  // Batch versions of the above, for plotting and analysis sweeps.
+  virtual void response (const double* normalizedFrequencies,
+                         complex_t* out,
+                         int numFrequencies) const = 0;
+
+  virtual void magnitudeResponse (const double* normalizedFrequencies,
+                                  double* out,
+                                  int numFrequencies) const = 0;
+
+  // Group delay in samples.
+  virtual void groupDelay (const double* normalizedFrequencies,
+                           double* out,
+                           int numFrequencies) const = 0;
+
   virtual int getNumChannels() = 0;
   virtual void reset () = 0;
   virtual void process (int numSamples, float* const* arrayOfChannels) = 0;
@@ -152,6 +166,12 @@ public:
     return m_design.getDefaultParams();
   }
 
+  // The design itself, for example to run its cascade through a FilterBank
+  const DesignClass& getDesign () const
+  {
+    return m_design;
+  }
+
   ParamInfo getParamInfo (int index) const
   {
     switch (index)
@@ -179,6 +199,27 @@ public:
     return m_design.response (normalizedFrequency);
   }
 
+  void response (const double* normalizedFrequencies,
+                 complex_t* out,
+                 int numFrequencies) const
+  {
+    m_design.response (normalizedFrequencies, out, numFrequencies);
+  }
+
+  void magnitudeResponse (const double* normalizedFrequencies,
+                          double* out,
+                          int numFrequencies) const
+  {
+    m_design.magnitudeResponse (normalizedFrequencies, out, numFrequencies);
+  }
+
+  void groupDelay (const double* normalizedFrequencies,
+                   double* out,
+                   int numFrequencies) const
+  {
+    m_design.groupDelay (normalizedFrequencies, out, numFrequencies);
+  }
+
 protected:
   void doSetParams (const Params& parameters)
   {
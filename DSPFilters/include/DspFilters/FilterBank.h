@@ -0,0 +1,285 @@
+/*******************************************************************************
+
+"A Collection of Useful C++ Classes for Digital Signal Processing"
+ By Vincent Falco
+
+Official project location:
+http://code.google.com/p/dspfilterscpp/
+
+See Documentation.cpp for contact information, notes, and bibliography.
+
+--------------------------------------------------------------------------------
+
+License: MIT License (http://www.opensource.org/licenses/mit-license.php)
+Copyright (c) 2009 by Vincent Falco
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+
+*******************************************************************************/
+
+
+
+#ifndef DSPFILTERS_FILTERBANK_H
+#define DSPFILTERS_FILTERBANK_H
+
+#include "DspFilters/Common.h"
+#include "DspFilters/Cascade.h"
+#include "DspFilters/MathSupplement.h"
+
+namespace Dsp {
+
+/*
+ * Bank of cascades sharing one input.
+ *
+ * Each filter of the bank is a cascade in Direct Form II, and every sample
+ * of the input is read once and run through all of them, writing one
+ * output per filter. Coefficients and states are laid out structure of
+ * arrays, with the filters innermost, so that the same stage of every
+ * filter is updated together and the compiler can do it in vector
+ * registers, one filter per lane.
+ *
+ * Filters with fewer stages than the others are padded with pass through
+ * stages, and each output is the same as processing the filter's cascade
+ * directly with DirectFormII.
+ *
+ */
+
+template <int NumFilters, int MaxStages>
+class FilterBank
+{
+public:
+  // State for processing one channel through every filter
+  class State : private DenormalPrevention
+  {
+  public:
+    State ()
+    {
+      reset ();
+    }
+
+    void reset ()
+    {
+      for (int s = 0; s < MaxStages; ++s)
+      {
+        for (int f = 0; f < NumFilters; ++f)
+        {
+          m_v1[s][f] = 0;
+          m_v2[s][f] = 0;
+        }
+      }
+
+      DenormalPrevention::resetAc ();
+    }
+
+  private:
+    friend class FilterBank;
+
+    double m_v1[MaxStages][NumFilters];
+    double m_v2[MaxStages][NumFilters];
+  };
+
+  FilterBank ()
+    : m_numStages (1)
+  {
+    for (int f = 0; f < NumFilters; ++f)
+    {
+      m_filterStages[f] = 0;
+
+      for (int s = 0; s < MaxStages; ++s)
+        setPassThrough (s, f);
+    }
+  }
+
+  // Take on the coefficients of a cascade for one filter. Returns false,
+  // leaving the filter as it was, if the cascade has more than MaxStages
+  // stages.
+  bool setFilter (int index, const Cascade& cascade)
+  {
+    assert (index >= 0 && index < NumFilters);
+
+    const int numStages = cascade.getNumStages ();
+
+    if (numStages > MaxStages)
+      return false;
+
+    for (int s = 0; s < MaxStages; ++s)
+    {
+      if (s < numStages)
+      {
+        const Cascade::Stage& stage = cascade[s];
+        m_a1[s][index] = stage.m_a1;
+        m_a2[s][index] = stage.m_a2;
+        m_b0[s][index] = stage.m_b0;
+        m_b1[s][index] = stage.m_b1;
+        m_b2[s][index] = stage.m_b2;
+      }
+      else
+      {
+        setPassThrough (s, index);
+      }
+    }
+
+    m_filterStages[index] = numStages;
+
+    // Only run as many stages as the longest filter needs
+    m_numStages = 1;
+    for (int f = 0; f < NumFilters; ++f)
+      if (m_filterStages[f] > m_numStages)
+        m_numStages = m_filterStages[f];
+
+    return true;
+  }
+
+  // Take on the coefficients a fraction t of the way from one bank to
+  // another, stage by stage. Either bank may be this one. The stability
+  // region of a stage is convex in (a1, a2), so if both banks are stable
+  // then so is every bank in between.
+  void interpolate (const FilterBank& from, const FilterBank& to, double t)
+  {
+    for (int s = 0; s < MaxStages; ++s)
+    {
+      for (int f = 0; f < NumFilters; ++f)
+      {
+        m_a1[s][f] = from.m_a1[s][f] + t * (to.m_a1[s][f] - from.m_a1[s][f]);
+        m_a2[s][f] = from.m_a2[s][f] + t * (to.m_a2[s][f] - from.m_a2[s][f]);
+        m_b0[s][f] = from.m_b0[s][f] + t * (to.m_b0[s][f] - from.m_b0[s][f]);
+        m_b1[s][f] = from.m_b1[s][f] + t * (to.m_b1[s][f] - from.m_b1[s][f]);
+        m_b2[s][f] = from.m_b2[s][f] + t * (to.m_b2[s][f] - from.m_b2[s][f]);
+      }
+    }
+
+    // Stages beyond either filter are pass through in both
+    m_numStages = from.m_numStages > to.m_numStages ? from.m_numStages : to.m_numStages;
+    for (int f = 0; f < NumFilters; ++f)
+      m_filterStages[f] = from.m_filterStages[f] > to.m_filterStages[f] ?
+        from.m_filterStages[f] : to.m_filterStages[f];
+  }
+
+  int getNumStages () const
+  {
+    return m_numStages;
+  }
+
+  // Run a block of one channel through every filter, writing the output of
+  // filter i to outputs[i]. The input may be one of the outputs.
+  template <typename Sample>
+  void process (int numSamples,
+                const Sample* input,
+                Sample* const* outputs,
+                State& state) const
+  {
+    // Fixed stage counts let the compiler unroll the stages completely
+    switch (m_numStages)
+    {
+    case 1:  processStages <1> (numSamples, input, outputs, state); break;
+    case 2:  processStages <limit (2)> (numSamples, input, outputs, state); break;
+    case 3:  processStages <limit (3)> (numSamples, input, outputs, state); break;
+    case 4:  processStages <limit (4)> (numSamples, input, outputs, state); break;
+    default: processStages <MaxStages> (numSamples, input, outputs, state); break;
+    };
+  }
+
+private:
+  static constexpr int limit (int numStages)
+  {
+    return numStages < MaxStages ? numStages : MaxStages;
+  }
+
+  template <int NumStages, typename Sample>
+  void processStages (int numSamples,
+                      const Sample* input,
+                      Sample* const* outputs,
+                      State& state) const
+  {
+    // Local copies, which can't alias the samples
+    double v1 [NumStages][NumFilters];
+    double v2 [NumStages][NumFilters];
+
+    for (int s = 0; s < NumStages; ++s)
+    {
+      for (int f = 0; f < NumFilters; ++f)
+      {
+        v1[s][f] = state.m_v1[s][f];
+        v2[s][f] = state.m_v2[s][f];
+      }
+    }
+
+    for (int i = 0; i < numSamples; ++i)
+    {
+      double x [NumFilters];
+      const double in = input[i];
+
+      for (int f = 0; f < NumFilters; ++f)
+        x[f] = in;
+
+      // The denormal offset goes into the first stage only, as in Cascade
+      double vsa = state.ac ();
+
+      for (int s = 0; s < NumStages; ++s)
+      {
+        for (int f = 0; f < NumFilters; ++f)
+        {
+          // The same expression as DirectFormII::process1
+          const double w = x[f] - m_a1[s][f]*v1[s][f] - m_a2[s][f]*v2[s][f] + vsa;
+          x[f] = m_b0[s][f]*w + m_b1[s][f]*v1[s][f] + m_b2[s][f]*v2[s][f];
+
+          v2[s][f] = v1[s][f];
+          v1[s][f] = w;
+        }
+
+        vsa = 0;
+      }
+
+      for (int f = 0; f < NumFilters; ++f)
+        outputs[f][i] = static_cast<Sample> (x[f]);
+    }
+
+    for (int s = 0; s < NumStages; ++s)
+    {
+      for (int f = 0; f < NumFilters; ++f)
+      {
+        state.m_v1[s][f] = v1[s][f];
+        state.m_v2[s][f] = v2[s][f];
+      }
+    }
+  }
+
+  void setPassThrough (int stage, int index)
+  {
+    m_a1[stage][index] = 0;
+    m_a2[stage][index] = 0;
+    m_b0[stage][index] = 1;
+    m_b1[stage][index] = 0;
+    m_b2[stage][index] = 0;
+  }
+
+  int m_numStages;
+  int m_filterStages[NumFilters];
+
+  // Coefficients normalised by a0, one row per stage
+  double m_a1[MaxStages][NumFilters];
+  double m_a2[MaxStages][NumFilters];
+  double m_b0[MaxStages][NumFilters];
+  double m_b1[MaxStages][NumFilters];
+  double m_b2[MaxStages][NumFilters];
+};
+
+}
+
+#endif
@@ -0,0 +1,204 @@
+/*******************************************************************************
+
+"A Collection of Useful C++ Classes for Digital Signal Processing"
+ By Vincent Falco
+
+Official project location:
+http://code.google.com/p/dspfilterscpp/
+
+See Documentation.cpp for contact information, notes, and bibliography.
+
+--------------------------------------------------------------------------------
+
+License: MIT License (http://www.opensource.org/licenses/mit-license.php)
+Copyright (c) 2009 by Vincent Falco
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+
+*******************************************************************************/
+
+
+
+#ifndef DSPFILTERS_FIXEDCASCADE_H
+#define DSPFILTERS_FIXEDCASCADE_H
+
+#include "DspFilters/Common.h"
+#include "DspFilters/Biquad.h"
+#include "DspFilters/Cascade.h"
+#include "DspFilters/MathSupplement.h"
+#include "DspFilters/State.h"
+
+namespace Dsp {
+
+namespace detail {
+
+// Runs a sample through stages First to NumStages - 1, expanding to one
+// call per stage at compile time
+template <int First, int NumStages>
+struct fixedStages
+{
+  template <class StateType>
+  static inline double process (double in,
+                                const BiquadBase* stages,
+                                StateType* states)
+  {
+    return fixedStages <First + 1, NumStages>::process (
+      states[First].process1 (in, stages[First], 0.), stages, states);
+  }
+};
+
+template <int NumStages>
+struct fixedStages <NumStages, NumStages>
+{
+  template <class StateType>
+  static inline double process (double in,
+                                const BiquadBase*,
+                                StateType*)
+  {
+    return in;
+  }
+};
+
+}
+
+/*
+ * Cascade of a number of stages known at compile time.
+ *
+ * Takes the place of CascadeStages when the order is fixed. The stage
+ * count is a template parameter, so the per sample loop over the stages
+ * is expanded into straight line code and the states are kept in locals
+ * for a whole block instead of being loaded and stored for every sample.
+ * The coefficients are held contiguously in one aligned struct.
+ *
+ * A cascade with fewer stages is padded with pass through stages, and the
+ * output is the same as processing the cascade directly.
+ *
+ */
+
+template <int NumStages, class StateType = DirectFormII>
+class FixedCascade
+{
+public:
+  // State for processing one channel
+  class State : private DenormalPrevention
+  {
+  public:
+    State ()
+    {
+      reset ();
+    }
+
+    void reset ()
+    {
+      for (int i = 0; i < NumStages; ++i)
+        m_states[i].reset ();
+
+      DenormalPrevention::resetAc ();
+    }
+
+  private:
+    friend class FixedCascade;
+
+    StateType m_states[NumStages];
+  };
+
+  FixedCascade ()
+  {
+    for (int i = 0; i < NumStages; ++i)
+      setPassThrough (m_coeffs.stages[i]);
+  }
+
+  // Take on the coefficients of a cascade. Returns false, leaving the
+  // coefficients as they were, if the cascade has more than NumStages stages.
+  bool setCascade (const Cascade& cascade)
+  {
+    const int numStages = cascade.getNumStages ();
+
+    if (numStages > NumStages)
+      return false;
+
+    for (int i = 0; i < NumStages; ++i)
+    {
+      if (i < numStages)
+        m_coeffs.stages[i] = cascade[i];
+      else
+        setPassThrough (m_coeffs.stages[i]);
+    }
+
+    return true;
+  }
+
+  int getNumStages () const
+  {
+    return NumStages;
+  }
+
+  const BiquadBase& operator[] (int index) const
+  {
+    assert (index >= 0 && index < NumStages);
+    return m_coeffs.stages[index];
+  }
+
+  // Process a block of samples
+  template <typename Sample>
+  void process (int numSamples, Sample* dest, State& state) const
+  {
+    const BiquadBase* stages = m_coeffs.stages;
+
+    // Local copies, which the compiler can keep in registers
+    StateType states [NumStages];
+    for (int i = 0; i < NumStages; ++i)
+      states[i] = state.m_states[i];
+
+    while (--numSamples >= 0)
+    {
+      // The denormal offset goes into the first stage only, as in Cascade
+      double out = states[0].process1 (static_cast<double> (*dest), stages[0], state.ac ());
+      out = detail::fixedStages <1, NumStages>::process (out, stages, states);
+      *dest++ = static_cast<Sample> (out);
+    }
+
+    for (int i = 0; i < NumStages; ++i)
+      state.m_states[i] = states[i];
+  }
+
+private:
+  static void setPassThrough (BiquadBase& stage)
+  {
+    stage.m_a0 = 1;
+    stage.m_a1 = 0;
+    stage.m_a2 = 0;
+    stage.m_b0 = 1;
+    stage.m_b1 = 0;
+    stage.m_b2 = 0;
+  }
+
+  // Aligned to 16 bytes, which every heap allocation guarantees, so that
+  // pairs of coefficients can be loaded together
+  struct alignas (16) Coefficients
+  {
+    BiquadBase stages[NumStages];
+  };
+
+  Coefficients m_coeffs;
+};
+
+}
+
+#endif
@@ -38,6 +38,7 @@ THE SOFTWARE.
 
 #include "DspFilters/Common.h"
 #include "DspFilters/MathSupplement.h"
+#include "DspFilters/Types.h"
 
 namespace Dsp {
 
@@ -76,6 +77,17 @@ public:
     m_numPoles = 0;
   }
 
+  // Take on the poles, zeros and normalization of another layout
+  void copyFrom (const LayoutBase& other)
+  {
+    assert (other.m_numPoles <= m_maxPoles);
+    m_numPoles = other.m_numPoles;
+    for (int i = 0; i < (m_numPoles+1)/2; ++i)
+      m_pair[i] = other.m_pair[i];
+    m_normalW = other.m_normalW;
+    m_normalGain = other.m_normalGain;
+  }
+
   int getNumPoles () const
   {
     return m_numPoles;
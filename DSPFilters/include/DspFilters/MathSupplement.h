@@ -133,6 +133,12 @@ public:
   {
   }
 
+  // restart the alternation, so processing is reproducible
+  void resetAc ()
+  {
+    m_v = anti_denormal_vsa;
+  }
+
   // small alternating current
   inline double ac ()
   {
@@ -0,0 +1,186 @@
+/*******************************************************************************
+
+"A Collection of Useful C++ Classes for Digital Signal Processing"
+ By Vincent Falco
+
+Official project location:
+http://code.google.com/p/dspfilterscpp/
+
+See Documentation.cpp for contact information, notes, and bibliography.
+
+--------------------------------------------------------------------------------
+
+License: MIT License (http://www.opensource.org/licenses/mit-license.php)
+Copyright (c) 2009 by Vincent Falco
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+
+*******************************************************************************/
+
+
+#ifndef DSPFILTERS_PARALLELFORM_H
+#define DSPFILTERS_PARALLELFORM_H
+
+#include "DspFilters/Common.h"
+#include "DspFilters/Cascade.h"
+#include "DspFilters/MathSupplement.h"
+
+namespace Dsp {
+
+/*
+ * Parallel form of a cascade.
+ *
+ * The transfer function of a cascade is expanded into partial fractions,
+ * one per pole, which are paired back up into real second order sections
+ * that all see the same input. Their outputs are summed with a direct
+ * term. Unlike the cascade, no section waits on another, so the sections
+ * of one sample can be evaluated side by side.
+ *
+ * The expansion needs distinct poles. Use getResponseError() to compare
+ * the result with the cascade it came from.
+ *
+ */
+
+class ParallelForm
+{
+public:
+  enum
+  {
+    maxSections = 32
+  };
+
+  // State for processing one channel in parallel form
+  class State : private DenormalPrevention
+  {
+  public:
+    State ()
+    {
+      reset ();
+    }
+
+    void reset ()
+    {
+      for (int i = 0; i < maxSections; ++i)
+      {
+        m_s1[i] = 0;
+        m_s2[i] = 0;
+      }
+
+      DenormalPrevention::resetAc ();
+    }
+
+  private:
+    friend class ParallelForm;
+
+    // Transposed direct form II state of each section
+    double m_s1[maxSections];
+    double m_s2[maxSections];
+  };
+
+  ParallelForm ();
+
+  // Expand a cascade. Returns false, leaving the form unchanged, when the
+  // cascade has repeated poles or more zeros than poles.
+  bool setCascade (const Cascade& cascade);
+
+  int getNumSections () const
+  {
+    return m_numSections;
+  }
+
+  double getDirectTerm () const
+  {
+    return m_direct;
+  }
+
+  // Calculate filter response at the given normalized frequency.
+  complex_t response (double normalizedFrequency) const;
+
+  // Largest difference between this form's response and the cascade's over
+  // numFrequencies frequencies up to Nyquist, relative to the cascade's peak.
+  double getResponseError (const Cascade& cascade,
+                           int numFrequencies = 512) const;
+
+  // Process a block of samples
+  template <typename Sample>
+  void process (int numSamples, Sample* dest, State& state) const
+  {
+    // Fixed section counts let the compiler keep all state in registers
+    switch (m_numSections)
+    {
+    case 1:  processSections <1> (numSamples, dest, state, 1); break;
+    case 2:  processSections <2> (numSamples, dest, state, 2); break;
+    case 3:  processSections <3> (numSamples, dest, state, 3); break;
+    case 4:  processSections <4> (numSamples, dest, state, 4); break;
+    default: processSections <maxSections> (numSamples, dest, state, m_numSections); break;
+    };
+  }
+
+private:
+  template <int MaxSections, typename Sample>
+  void processSections (int numSamples, Sample* dest, State& state, const int n) const
+  {
+    double s1 [MaxSections];
+    double s2 [MaxSections];
+
+    for (int i = 0; i < n; ++i)
+    {
+      s1[i] = state.m_s1[i];
+      s2[i] = state.m_s2[i];
+    }
+
+    while (--numSamples >= 0)
+    {
+      const double in = *dest + state.ac ();
+      double out = m_direct * in;
+
+      // No section waits on another, so their recursions overlap
+      for (int i = 0; i < n; ++i)
+      {
+        const double y = m_b0[i]*in + s1[i];
+        s1[i] = m_b1[i]*in - m_a1[i]*y + s2[i];
+        s2[i] =            - m_a2[i]*y;
+        out += y;
+      }
+
+      *dest++ = static_cast<Sample> (out);
+    }
+
+    for (int i = 0; i < n; ++i)
+    {
+      state.m_s1[i] = s1[i];
+      state.m_s2[i] = s2[i];
+    }
+  }
+
+  void addSection (double b0, double b1, double a1, double a2);
+
+  int m_numSections;
+  double m_direct;
+
+  // Sections are b0 + b1 z^-1 over 1 + a1 z^-1 + a2 z^-2
+  double m_b0[maxSections];
+  double m_b1[maxSections];
+  double m_a1[maxSections];
+  double m_a2[maxSections];
+};
+
+}
+
+#endif
@@ -0,0 +1,119 @@
+/*******************************************************************************
+
+"A Collection of Useful C++ Classes for Digital Signal Processing"
+ By Vincent Falco
+
+Official project location:
+http://code.google.com/p/dspfilterscpp/
+
+See Documentation.cpp for contact information, notes, and bibliography.
+
+--------------------------------------------------------------------------------
+
+License: MIT License (http://www.opensource.org/licenses/mit-license.php)
+Copyright (c) 2009 by Vincent Falco
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+
+*******************************************************************************/
+
+
+#ifndef DSPFILTERS_PROTOTYPECACHE_H
+#define DSPFILTERS_PROTOTYPECACHE_H
+
+#include "DspFilters/Common.h"
+#include "DspFilters/Layout.h"
+
+namespace Dsp {
+
+/*
+ * Process-wide cache of analog prototypes.
+ *
+ * Prototypes that are found by solving for polynomial roots are costly to
+ * design, yet depend only on their family, order and shape parameters.
+ * Each one is designed once and then shared by every filter in the
+ * process, so new filter objects and switches between designs only copy
+ * the poles and zeros.
+ *
+ * Entries are immutable once added and are never removed before the
+ * process ends. Looking one up is lock-free and doesn't allocate, so it
+ * is safe on the audio thread. Adding one allocates, so a prototype that
+ * the audio thread will need should first be designed somewhere else,
+ * for example by setting up a filter while preparing to play.
+ *
+ * Prototypes that depend only on their order are always cached, as there
+ * are only as many of them as there are orders. Shaped prototypes, whose
+ * shelf gain or elliptic ripple and rolloff vary continuously, could
+ * otherwise fill the cache with one entry per automation step, so they
+ * are kept apart with a separate and smaller limit. Filling it never keeps
+ * the ordinary low pass prototypes out or slows down finding them.
+ *
+ */
+
+class PrototypeCache
+{
+public:
+  enum Family
+  {
+    // Keyed by order alone
+    besselLowPass,
+    legendreLowPass,
+
+    // Keyed by order and continuous shape parameters
+    besselLowShelf,
+    ellipticLowPass
+  };
+
+  enum
+  {
+    // Past these many entries of each kind, prototypes are designed by
+    // each filter instead. Orders are bounded by the root finders, so the
+    // first is never reached in practice.
+    maxOrderEntries = 256,
+    maxShapedEntries = 64
+  };
+
+  static bool isShaped (Family family);
+
+  // Copy a prototype into the layout. Returns false if it isn't cached.
+  static bool find (Family family,
+                    int numPoles,
+                    double param1,
+                    double param2,
+                    LayoutBase& proto);
+
+  // Add a designed prototype, unless it is already cached or its kind of
+  // entry is at the limit.
+  static void add (Family family,
+                   int numPoles,
+                   double param1,
+                   double param2,
+                   const LayoutBase& proto);
+
+  static int getNumEntries ();
+  static int getNumShapedEntries ();
+
+  // Remove every entry, so that tools measuring designs can start from a
+  // cold cache. Not safe while any filter is being set up.
+  static void clear ();
+};
+
+}
+
+#endif
@@ -115,6 +115,18 @@ public:
     }
   }
 
+  // Clears the state and skips any transition in progress
+  void reset ()
+  {
+    filter_type_t::reset ();
+
+    if (m_remainingSamples > 0)
+    {
+      m_remainingSamples = 0;
+      m_transitionParams = this->getParams();
+    }
+  }
+
   void process (int numSamples, float* const* arrayOfChannels)
   {
     processBlock (numSamples, arrayOfChannels);
@@ -0,0 +1,208 @@
+/*******************************************************************************
+
+"A Collection of Useful C++ Classes for Digital Signal Processing"
+ By Vincent Falco
+
+Official project location:
+http://code.google.com/p/dspfilterscpp/
+
+See Documentation.cpp for contact information, notes, and bibliography.
+
+--------------------------------------------------------------------------------
+
+License: MIT License (http://www.opensource.org/licenses/mit-license.php)
+Copyright (c) 2009 by Vincent Falco
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+
+*******************************************************************************/
+
+
+#ifndef DSPFILTERS_STATESPACE_H
+#define DSPFILTERS_STATESPACE_H
+
+#include "DspFilters/Common.h"
+#include "DspFilters/Cascade.h"
+#include "DspFilters/MathSupplement.h"
+
+namespace Dsp {
+
+/*
+ * Block state space form of a cascade.
+ *
+ * The cascade is realised as one state space system of order N
+ * (two states per stage), from which the matrices that advance it by a
+ * whole block of K samples are precomputed:
+ *
+ *  y[block] = O * x + T * u[block]
+ *  x'       = A^K * x + G * u[block]
+ *
+ * where O stacks C * A^i, T is the lower triangular matrix of impulse
+ * response terms and G stacks A^(K-1-j) * B. Every output of a block is
+ * then an independent dot product instead of the end of a recursive
+ * chain, so the work vectorizes. All four matrices are kept as one
+ * stacked matrix, which is a single matrix-vector product per block.
+ * Samples that don't fill a whole block are run through the single step
+ * system.
+ *
+ * The matrices are only rebuilt when the cascade's coefficients change.
+ *
+ */
+
+class BlockStateSpace
+{
+public:
+  enum
+  {
+    blockSize = 8,
+    maxStages = 8,
+    maxOrder = 2 * maxStages
+  };
+
+  // State for processing one channel in block form
+  class State : private DenormalPrevention
+  {
+  public:
+    State ()
+    {
+      reset ();
+    }
+
+    void reset ()
+    {
+      for (int i = 0; i < maxOrder; ++i)
+        m_x[i] = 0;
+
+      DenormalPrevention::resetAc ();
+    }
+
+  private:
+    friend class BlockStateSpace;
+
+    double m_x[maxOrder];
+  };
+
+  BlockStateSpace ();
+
+  // Take on the coefficients of a cascade, rebuilding the matrices only if
+  // they differ from the last ones. Returns false if the cascade has more
+  // than maxStages stages.
+  bool setCascade (const Cascade& cascade);
+
+  int getOrder () const
+  {
+    return m_order;
+  }
+
+  // Process a block of samples
+  template <typename Sample>
+  void process (int numSamples, Sample* dest, State& state) const
+  {
+    // Fixed orders let the compiler unroll the matrix products completely
+    switch (m_numStages)
+    {
+    case 1:  processBlocks <2> (numSamples, dest, state); break;
+    case 2:  processBlocks <4> (numSamples, dest, state); break;
+    case 3:  processBlocks <6> (numSamples, dest, state); break;
+    case 4:  processBlocks <8> (numSamples, dest, state); break;
+    default: processBlocks <maxOrder> (numSamples, dest, state); break;
+    };
+  }
+
+private:
+  template <int Order, typename Sample>
+  void processBlocks (int numSamples, Sample* dest, State& state) const
+  {
+    // The block inputs come first and the states after them, so a state
+    // has the same place in the stacked matrix whatever the order is.
+    // Unused states of the largest order have zero columns.
+    enum { size = blockSize + Order };
+
+    double in [size];
+
+    for (int r = 0; r < Order; ++r)
+      in[blockSize + r] = state.m_x[r];
+
+    while (numSamples >= blockSize)
+    {
+      double out [size];
+
+      for (int i = 0; i < blockSize; ++i)
+        in[i] = dest[i];
+
+      // One alternating offset per block is enough to keep the states normal
+      in[0] += state.ac ();
+
+      for (int i = 0; i < size; ++i)
+        out[i] = 0;
+
+      // Every output and next state is independent of the others, so each
+      // column is a whole vector of products
+      for (int j = 0; j < size; ++j)
+        for (int i = 0; i < size; ++i)
+          out[i] += m_M[j][i] * in[j];
+
+      for (int i = 0; i < blockSize; ++i)
+        dest[i] = static_cast<Sample> (out[i]);
+
+      for (int r = 0; r < Order; ++r)
+        in[blockSize + r] = out[blockSize + r];
+
+      dest += blockSize;
+      numSamples -= blockSize;
+    }
+
+    for (int r = 0; r < Order; ++r)
+      state.m_x[r] = in[blockSize + r];
+
+    // Samples that don't fill a block take the single step system
+    while (--numSamples >= 0)
+    {
+      *dest = static_cast<Sample> (processSample (*dest + state.ac (), state.m_x));
+      ++dest;
+    }
+  }
+
+  void rebuild ();
+  double processSample (double u, double* x) const;
+
+  int m_numStages;
+  int m_order;
+
+  // Coefficients the matrices were built from, normalised by a0
+  double m_coeffs [maxStages][5];
+
+  // Single step system, matrices stored by column
+  double m_A [maxOrder][maxOrder];
+  double m_B [maxOrder];
+  double m_C [maxOrder];
+  double m_D;
+
+  // Block system, stored by column so that the inner loop runs down
+  // contiguous memory:
+  //
+  //  [ y  ]   [ T  O  ] [ u ]
+  //  [ x' ] = [ G  AK ] [ x ]
+  //
+  double m_M [blockSize + maxOrder][blockSize + maxOrder];
+};
+
+}
+
+#endif
@@ -0,0 +1,348 @@
+/*******************************************************************************
+
+"A Collection of Useful C++ Classes for Digital Signal Processing"
+ By Vincent Falco
+
+Official project location:
+http://code.google.com/p/dspfilterscpp/
+
+See Documentation.cpp for contact information, notes, and bibliography.
+
+--------------------------------------------------------------------------------
+
+License: MIT License (http://www.opensource.org/licenses/mit-license.php)
+Copyright (c) 2009 by Vincent Falco
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+
+*******************************************************************************/
+
+
+
+#ifndef DSPFILTERS_STATEVARIABLE_H
+#define DSPFILTERS_STATEVARIABLE_H
+
+#include "DspFilters/Common.h"
+#include "DspFilters/Biquad.h"
+#include "DspFilters/Design.h"
+#include "DspFilters/Filter.h"
+#include "DspFilters/MathSupplement.h"
+
+namespace Dsp {
+
+/*
+ * Topology preserving (zero delay feedback) state variable filter, after
+ * Andrew Simper's trapezoidal integrator formulation:
+ *
+ * http://www.cytomic.com/files/dsp/SvfLinearTrapOptimised2.pdf
+ *
+ * One update gives the low, band and high pass outputs together. The
+ * state lives in the integrators rather than in past samples, so the
+ * coefficients can change on every sample without the filter blowing up,
+ * and computing them takes one tan (or a table lookup) and one division
+ * instead of a redesign. That makes it a cheap building block for a
+ * crossover whose frequency is modulated at audio rate.
+ *
+ * The band pass output has a peak gain of Q.
+ *
+ */
+
+namespace StateVariable {
+
+// Largest cutoff, as a fraction of the sampling rate
+const double maxNormalizedCutoff = 0.49;
+
+// Prewarped integrator gain tan (pi * normalizedCutoff), read from a table.
+// Within 0.01% of the exact value up to 0.45, and 0.2% at maxNormalizedCutoff.
+double prewarp (double normalizedCutoff);
+
+class Coefficients
+{
+public:
+  Coefficients ();
+
+  // Exact cutoff, one tan per call
+  void setup (double sampleRate,
+              double cutoffFrequency,
+              double q);
+
+  // Cutoff as a fraction of the sampling rate, keeping Q. This uses the
+  // prewarp table and is cheap enough to call every sample.
+  void setNormalizedCutoff (double normalizedCutoff)
+  {
+    setGain (prewarp (normalizedCutoff));
+  }
+
+  double getQ () const
+  {
+    return 1 / m_k;
+  }
+
+protected:
+  void setGain (double g)
+  {
+    m_g  = g;
+    m_a1 = 1 / (1 + g * (g + m_k));
+    m_a2 = g * m_a1;
+    m_a3 = g * m_a2;
+  }
+
+public:
+  double m_g;   // integrator gain
+  double m_k;   // damping, 1/Q
+  double m_a1;
+  double m_a2;
+  double m_a3;
+};
+
+// State for processing one channel
+class ChannelState : private DenormalPrevention
+{
+public:
+  ChannelState ()
+  {
+    reset ();
+  }
+
+  void reset ()
+  {
+    m_ic1eq = 0;
+    m_ic2eq = 0;
+    DenormalPrevention::resetAc ();
+  }
+
+  // Run one sample through, producing every output
+  inline void process1 (double in,
+                        const Coefficients& c,
+                        double& low,
+                        double& band,
+                        double& high)
+  {
+    in += ac ();
+
+    const double v3 = in - m_ic2eq;
+    const double v1 = c.m_a1 * m_ic1eq + c.m_a2 * v3;
+    const double v2 = m_ic2eq + c.m_a2 * m_ic1eq + c.m_a3 * v3;
+
+    m_ic1eq = 2 * v1 - m_ic1eq;
+    m_ic2eq = 2 * v2 - m_ic2eq;
+
+    low  = v2;
+    band = v1;
+    high = in - c.m_k * v1 - v2;
+  }
+
+private:
+  double m_ic1eq;
+  double m_ic2eq;
+};
+
+// Split a channel into low and high pass outputs in one pass
+template <typename Sample>
+void split (int numSamples,
+            const Sample* in,
+            Sample* low,
+            Sample* high,
+            const Coefficients& c,
+            ChannelState& state)
+{
+  double l, b, h;
+  while (--numSamples >= 0)
+  {
+    state.process1 (*in++, c, l, b, h);
+    *low++  = static_cast<Sample> (l);
+    *high++ = static_cast<Sample> (h);
+  }
+}
+
+// As above, with the cutoff (a fraction of the sampling rate) given for
+// every sample. The coefficients are left at the last cutoff.
+template <typename Sample>
+void split (int numSamples,
+            const Sample* in,
+            Sample* low,
+            Sample* high,
+            const float* normalizedCutoff,
+            Coefficients& c,
+            ChannelState& state)
+{
+  double l, b, h;
+  while (--numSamples >= 0)
+  {
+    c.setNormalizedCutoff (*normalizedCutoff++);
+    state.process1 (*in++, c, l, b, h);
+    *low++  = static_cast<Sample> (l);
+    *high++ = static_cast<Sample> (h);
+  }
+}
+
+//------------------------------------------------------------------------------
+
+//
+// Raw filters, each picking one output
+//
+
+// The equivalent biquad is kept up to date for the response and pole/zero
+// queries. Processing never uses it.
+struct Base : Coefficients, BiquadBase
+{
+  // Every channel uses the filter's own state, whatever form is asked for
+  template <class StateType>
+  struct State : ChannelState
+  {
+    template <typename Sample, class FilterClass>
+    inline Sample process (const Sample in, const FilterClass& f)
+    {
+      return static_cast<Sample> (f.process1 (in, *this));
+    }
+  };
+
+protected:
+  // Numerator of the output, in terms of g
+  void setEquivalent (double b0, double b1, double b2);
+};
+
+struct LowPass : Base
+{
+  void setup (double sampleRate,
+              double cutoffFrequency,
+              double q);
+
+  double process1 (double in, ChannelState& state) const
+  {
+    double l, b, h;
+    state.process1 (in, *this, l, b, h);
+    return l;
+  }
+
+  template <class StateType, typename Sample>
+  void process (int numSamples, Sample* dest, StateType& state) const
+  {
+    for (; --numSamples >= 0; ++dest)
+      *dest = static_cast<Sample> (process1 (*dest, state));
+  }
+};
+
+struct HighPass : Base
+{
+  void setup (double sampleRate,
+              double cutoffFrequency,
+              double q);
+
+  double process1 (double in, ChannelState& state) const
+  {
+    double l, b, h;
+    state.process1 (in, *this, l, b, h);
+    return h;
+  }
+
+  template <class StateType, typename Sample>
+  void process (int numSamples, Sample* dest, StateType& state) const
+  {
+    for (; --numSamples >= 0; ++dest)
+      *dest = static_cast<Sample> (process1 (*dest, state));
+  }
+};
+
+struct BandPass : Base
+{
+  void setup (double sampleRate,
+              double centerFrequency,
+              double q);
+
+  double process1 (double in, ChannelState& state) const
+  {
+    double l, b, h;
+    state.process1 (in, *this, l, b, h);
+    return b;
+  }
+
+  template <class StateType, typename Sample>
+  void process (int numSamples, Sample* dest, StateType& state) const
+  {
+    for (; --numSamples >= 0; ++dest)
+      *dest = static_cast<Sample> (process1 (*dest, state));
+  }
+};
+
+//------------------------------------------------------------------------------
+
+//
+// Gui-friendly Design layer
+//
+
+namespace Design {
+
+struct TypeIBase : DesignBase
+{
+  enum
+  {
+    NumParams = 3
+  };
+
+  static int getNumParams ()
+  {
+    return 3;
+  }
+
+  static const ParamInfo getParamInfo_1 ()
+  {
+    return ParamInfo::defaultCutoffFrequencyParam ();
+  }
+
+  static const ParamInfo getParamInfo_2 ()
+  {
+    return ParamInfo::defaultQParam ();
+  }
+};
+
+template <class FilterClass>
+struct TypeI : TypeIBase, FilterClass
+{
+  void setParams (const Params& params)
+  {
+    FilterClass::setup (params[0], params[1], params[2]);
+  }
+};
+
+struct LowPass : TypeI <StateVariable::LowPass>
+{
+  static Kind getKind () { return kindLowPass; }
+  static const char* getName() { return "State Variable Low Pass"; }
+};
+
+struct HighPass : TypeI <StateVariable::HighPass>
+{
+  static Kind getKind () { return kindHighPass; }
+  static const char* getName() { return "State Variable High Pass"; }
+};
+
+struct BandPass : TypeI <StateVariable::BandPass>
+{
+  static Kind getKind () { return kindBandPass; }
+  static const char* getName() { return "State Variable Band Pass"; }
+};
+
+}
+
+}
+
+}
+
+#endif
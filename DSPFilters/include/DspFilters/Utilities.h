@@ -45,6 +45,13 @@ namespace Dsp {
  *
  * These routines are handy for manipulating buffers of samples.
  *
+ * The templates are the reference implementations. For float and double
+ * buffers without a skip, overloads in Utilities.cpp do the same work with
+ * the instruction set CpuDispatch selected (SSE2, AVX2, AVX-512 or NEON),
+ * and fall back to the templates otherwise. Calling a template with
+ * explicit arguments, as in add<float, float> (...), always gets the
+ * reference.
+ *
  */
 
 //------------------------------------------------------------------------------
@@ -64,7 +71,7 @@ void add (int samples,
     ++destSkip;
     while (--samples >= 0)
     {
-      *dest = static_cast<Td>(*src);
+      *dest += static_cast<Td>(*src);
       dest += destSkip;
       src += srcSkip;
     }
@@ -76,6 +83,11 @@ void add (int samples,
   }
 }
 
+void add (int samples, float* dest, float const* src, int destSkip = 0, int srcSkip = 0);
+void add (int samples, double* dest, double const* src, int destSkip = 0, int srcSkip = 0);
+void add (int samples, double* dest, float const* src, int destSkip = 0, int srcSkip = 0);
+void add (int samples, float* dest, double const* src, int destSkip = 0, int srcSkip = 0);
+
 // Multichannel add
 template <typename Td,
           typename Ts>
@@ -108,7 +120,7 @@ void copy (int samples,
       ++destSkip;
       while (--samples >= 0)
       {
-        *dest++ = *src++;
+        *dest = *src;
         dest += destSkip;
         src += srcSkip;
       }
@@ -118,7 +130,7 @@ void copy (int samples,
       ++srcSkip;
       while (--samples >= 0)
       {
-        *dest++ = *src++;
+        *dest++ = *src;
         src += srcSkip;
       }
     }
@@ -153,6 +165,10 @@ void copy (int samples,
     ::memcpy (dest, src, samples * sizeof(src[0]));
 }
 
+// Conversions between float and double
+void copy (int samples, double* dest, float const* src, int destSkip = 0, int srcSkip = 0);
+void copy (int samples, float* dest, double const* src, int destSkip = 0, int srcSkip = 0);
+
 // Copy a set of channels from src to dest, with implicit type conversion.
 template <typename Td,
           typename Ts>
@@ -212,6 +228,10 @@ void deinterleave (int channels,
   };
 }
 
+// With fast paths for 2 and 8 channels
+void deinterleave (int channels, int samples, float* const* dest, float const* src);
+void deinterleave (int channels, int samples, double* const* dest, double const* src);
+
 // Convenience for a stereo pair of channels
 template <typename Td,
           typename Ts>
@@ -246,6 +266,11 @@ void fade (int samples,
   }
 }
 
+// The ramp is computed per sample rather than accumulated, so it can differ
+// from the reference in the last bits
+void fade (int samples, float* dest, float start = 0, float end = 1);
+void fade (int samples, double* dest, double start = 0, double end = 1);
+
 // Fade dest cannels
 template <typename Td,
           typename Ty>
@@ -274,11 +299,15 @@ void fade (int samples,
 
   while (--samples >= 0)
   {
-    *dest++ = static_cast<Td>(*dest + t * (*src++ - *dest));
+    *dest = static_cast<Td>(*dest + t * (*src++ - *dest));
+    ++dest;
     t += dt;
   }
 }
 
+void fade (int samples, float* dest, float const* src, float start = 0, float end = 1);
+void fade (int samples, double* dest, double const* src, double start = 0, double end = 1);
+
 // Fade src channels into dest channels
 template <typename Td,
           typename Ts,
@@ -347,6 +376,10 @@ void interleave (int channels,
   };
 }
 
+// With fast paths for 2 and 8 channels
+void interleave (int channels, size_t samples, float* dest, float const* const* src);
+void interleave (int channels, size_t samples, double* dest, double const* const* src);
+
 //--------------------------------------------------------------------------
 
 // Convenience for a stereo channel pair
@@ -385,10 +418,16 @@ void multiply (int samples,
   else
   {
     while (--samples >= 0)
-      *dest++ = static_cast<Td>(*dest * factor);
+    {
+      *dest = static_cast<Td>(*dest * factor);
+      ++dest;
+    }
   }
 }
 
+void multiply (int samples, float* dest, float factor, int destSkip = 0);
+void multiply (int samples, double* dest, double factor, int destSkip = 0);
+
 // Multiply a set of channels by a constant.
 template <typename Td,
           typename Ty>
@@ -434,6 +473,9 @@ void reverse (int samples,
   }
 }
 
+void reverse (int samples, float* dest, float const* src, int destSkip = 0, int srcSkip = 0);
+void reverse (int samples, double* dest, double const* src, int destSkip = 0, int srcSkip = 0);
+
 template <typename Td, typename Ts>
 void reverse (int channels, size_t frames, Td* const* dest, const Ts* const* src)
 {
@@ -443,6 +485,29 @@ void reverse (int channels, size_t frames, Td* const* dest, const Ts* const* src
 
 //--------------------------------------------------------------------------
 
+// Soft clip samples through the curve (1 + amount) x / (1 + amount |x|),
+// which leaves the ends of the range -1 and 1 where they are and rises with
+// a slope of 1 + amount through zero. The amount must not be negative.
+template <typename Td>
+void saturate (int samples,
+               Td* dest,
+               Td amount)
+{
+  const Td gain = 1 + amount;
+  while (--samples >= 0)
+  {
+    const Td x = *dest;
+    *dest++ = gain * x / (1 + amount * std::abs (x));
+  }
+}
+
+// The vector kernels divide through a reciprocal estimate refined by one
+// Newton step, so they can differ from the reference by a few units in the
+// last place
+void saturate (int samples, float* dest, float amount);
+
+//--------------------------------------------------------------------------
+
 template <typename Tn>
 void to_mono (int samples, Tn* dest, Tn const* left, Tn const* right)
 {
@@ -455,6 +520,9 @@ void to_mono (int samples, Tn* dest, Tn const* left, Tn const* right)
 #endif
 }
 
+void to_mono (int samples, float* dest, float const* left, float const* right);
+void to_mono (int samples, double* dest, double const* left, double const* right);
+
 //--------------------------------------------------------------------------
 
 template <typename T>
@@ -677,50 +745,153 @@ loop:
 
 //------------------------------------------------------------------------------
 
-// Tracks the peaks in the signal stream using the attack and release parameters
+// Tracks the level of the signal stream using the attack and release
+// parameters, either its peaks or, in RMS mode, its mean square.
+//
+// The channels are processed together, one sample at a time, so that their
+// envelopes occupy the lanes of a vector register. The attack or release
+// coefficient is selected per lane instead of branched on, which keeps the
+// loop free of data dependent branches.
 template <int Channels=2, typename Value=float>
 class EnvelopeFollower
 {
 public:
-  EnvelopeFollower()
+  enum Mode
+  {
+    modePeak,
+    modeRms
+  };
+
+  EnvelopeFollower (Mode mode = modePeak)
+    : m_mode (mode)
+    , m_a (0)
+    , m_r (0)
+  {
+    Reset ();
+  }
+
+  void Reset ()
   {
     for (int i = 0; i < Channels; i++)
       m_env[i]=0;
   }
 
+  // Current level of a channel, the root of the mean square in RMS mode
   Value operator[] (int channel) const
   {
-    return m_env[channel];
+    return static_cast<Value> (m_mode == modeRms ? std::sqrt (m_env[channel])
+                                                 : m_env[channel]);
   }
 
+  Mode GetMode () const
+  {
+    return m_mode;
+  }
+
+  void SetMode (Mode mode)
+  {
+    if (mode != m_mode)
+    {
+      m_mode = mode;
+      Reset ();
+    }
+  }
+
+  // Times are to 1% (-40 dB) of a step, zero being instant
   void Setup (int sampleRate, double attackMs, double releaseMs)
   {
-    m_a = pow (0.01, 1.0 / (attackMs * sampleRate * 0.001));
-    m_r = pow (0.01, 1.0 / (releaseMs * sampleRate * 0.001));
+    m_a = coefficient (sampleRate, attackMs);
+    m_r = coefficient (sampleRate, releaseMs);
   }
 
   void Process (size_t samples, const Value** src)
   {
-    for( int i=0; i<Channels; i++ )
+    process <Channels, false> (samples, src, 0, 0);
+  }
+
+  // Process all channels, writing the level after each sample to dest
+  void Process (size_t samples, const Value* const* src, Value* const* dest)
+  {
+    process <Channels, true> (samples, src, dest, 0);
+  }
+
+  // Process a single channel on its own
+  void Process (size_t samples, const Value* src, Value* dest, int channel)
+  {
+    assert (channel >= 0 && channel < Channels);
+    process <1, true> (samples, &src, &dest, channel);
+  }
+
+  double m_env[Channels];
+
+protected:
+  static double coefficient (int sampleRate, double ms)
+  {
+    const double samples = ms * sampleRate * 0.001;
+    return samples > 0 ? pow (0.01, 1.0 / samples) : 0;
+  }
+
+  template <int Lanes, bool Write>
+  void process (size_t samples, const Value* const* src, Value* const* dest, int first)
+  {
+    if (m_mode == modeRms)
+      process <Lanes, Write, true> (samples, src, dest, first);
+    else
+      process <Lanes, Write, false> (samples, src, dest, first);
+  }
+
+  template <int Lanes, bool Write, bool Squared>
+  void process (size_t samples, const Value* const* src, Value* const* dest, int first)
+  {
+    if (m_a <= m_r)
+      processLanes <Lanes, Write, Squared, true> (samples, src, dest, first);
+    else
+      processLanes <Lanes, Write, Squared, false> (samples, src, dest, first);
+  }
+
+  template <int Lanes, bool Write, bool Squared, bool FastAttack>
+  void processLanes (size_t samples, const Value* const* src, Value* const* dest, int first)
+  {
+    // Both updates are formed. The attack update is the larger one exactly
+    // when the level is above the envelope if the attack is the faster of
+    // the two (and the smaller one otherwise), so a max or min selects it
+    // without a comparison on the recursive path.
+    const double a = m_a;
+    const double r = m_r;
+    const double a1 = 1 - m_a;
+    const double r1 = 1 - m_r;
+
+    double e[Lanes];
+    const Value* in[Lanes];
+    Value* out[Lanes];
+    for (int c = 0; c < Lanes; ++c)
     {
-      const Value* cur = src[i];
+      e[c] = m_env[first + c];
+      in[c] = src[c];
+      out[c] = Write ? dest[c] : 0;
+    }
 
-      double e = m_env[i];
-      for (int n = samples; n; n--)
+    for (size_t n = 0; n < samples; ++n)
+    {
+      for (int c = 0; c < Lanes; ++c)
       {
-        double v = ::fabs(*cur++);
-        if (v > e)
-          e = m_a * (e - v) + v;
-        else
-          e = m_r * (e - v) + v;
+        const double x = in[c][n];
+        const double v = Squared ? x * x : std::fabs (x);
+        const double attack = a * e[c] + a1 * v;
+        const double release = r * e[c] + r1 * v;
+        e[c] = FastAttack ? std::max (attack, release) : std::min (attack, release);
+
+        if (Write)
+          out[c][n] = static_cast<Value> (Squared ? std::sqrt (e[c]) : e[c]);
       }
-      m_env[i]=e;
     }
-  }
 
-  double m_env[Channels];
+    // Flush a decayed envelope once per block, before it turns denormal
+    for (int c = 0; c < Lanes; ++c)
+      m_env[first + c] = (e[c] < 1e-30) ? 0 : e[c];
+  }
 
-protected:
+  Mode m_mode;
   double m_a;
   double m_r;
 };
@@ -0,0 +1,102 @@
+/*******************************************************************************
+
+"A Collection of Useful C++ Classes for Digital Signal Processing"
+ By Vincent Falco
+
+Official project location:
+http://code.google.com/p/dspfilterscpp/
+
+See Documentation.cpp for contact information, notes, and bibliography.
+
+--------------------------------------------------------------------------------
+
+License: MIT License (http://www.opensource.org/licenses/mit-license.php)
+Copyright (c) 2009 by Vincent Falco
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+
+*******************************************************************************/
+
+
+#ifndef DSPFILTERS_UTILITYKERNELS_H
+#define DSPFILTERS_UTILITYKERNELS_H
+
+#include "DspFilters/Common.h"
+#include "DspFilters/CpuDispatch.h"
+
+namespace Dsp {
+
+/*
+ * Entry points of the Utilities overloads for one instruction set.
+ *
+ * The kernels are written once, in UtilityKernelsImpl.h, and compiled
+ * into a table per set: the reference templates and the build's baseline
+ * in Utilities.cpp, AVX2 and AVX-512 in files of their own. The overloads
+ * look the table up from CpuDispatch::get () on each call. Only buffers
+ * without a skip get here.
+ *
+ */
+
+struct UtilityKernels
+{
+  void (*addFloat) (int samples, float* dest, float const* src);
+  void (*addDouble) (int samples, double* dest, double const* src);
+  void (*addFloatToDouble) (int samples, double* dest, float const* src);
+  void (*addDoubleToFloat) (int samples, float* dest, double const* src);
+
+  void (*copyFloatToDouble) (int samples, double* dest, float const* src);
+  void (*copyDoubleToFloat) (int samples, float* dest, double const* src);
+
+  void (*deinterleave2Float) (int samples, float* const* dest, float const* src);
+  void (*deinterleave2Double) (int samples, double* const* dest, double const* src);
+  void (*deinterleave8Float) (int samples, float* const* dest, float const* src);
+  void (*deinterleave8Double) (int samples, double* const* dest, double const* src);
+
+  void (*fadeFloat) (int samples, float* dest, float start, float end);
+  void (*fadeDouble) (int samples, double* dest, double start, double end);
+  void (*crossFadeFloat) (int samples, float* dest, float const* src, float start, float end);
+  void (*crossFadeDouble) (int samples, double* dest, double const* src, double start, double end);
+
+  void (*interleave2Float) (int samples, float* dest, float const* const* src);
+  void (*interleave2Double) (int samples, double* dest, double const* const* src);
+  void (*interleave8Float) (int samples, float* dest, float const* const* src);
+  void (*interleave8Double) (int samples, double* dest, double const* const* src);
+
+  void (*multiplyFloat) (int samples, float* dest, float factor);
+  void (*multiplyDouble) (int samples, double* dest, double factor);
+
+  void (*reverseFloat) (int samples, float* dest, float const* src);
+  void (*reverseDouble) (int samples, double* dest, double const* src);
+
+  void (*saturateFloat) (int samples, float* dest, float amount);
+
+  void (*toMonoFloat) (int samples, float* dest, float const* left, float const* right);
+  void (*toMonoDouble) (int samples, double* dest, double const* left, double const* right);
+};
+
+#if DSPFILTERS_X86
+const UtilityKernels& getAvx2UtilityKernels ();
+#if DSPFILTERS_AVX512
+const UtilityKernels& getAvx512UtilityKernels ();
+#endif
+#endif
+
+}
+
+#endif
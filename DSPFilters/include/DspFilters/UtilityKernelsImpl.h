@@ -0,0 +1,882 @@
+/*******************************************************************************
+
+"A Collection of Useful C++ Classes for Digital Signal Processing"
+ By Vincent Falco
+
+Official project location:
+http://code.google.com/p/dspfilterscpp/
+
+See Documentation.cpp for contact information, notes, and bibliography.
+
+--------------------------------------------------------------------------------
+
+License: MIT License (http://www.opensource.org/licenses/mit-license.php)
+Copyright (c) 2009 by Vincent Falco
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+
+*******************************************************************************/
+
+
+//
+// Kernels of the Utilities overloads, compiled once per instruction set.
+//
+// There is deliberately no include guard. A file includes this inside an
+// unnamed namespace within Dsp, after the intrinsics headers, with at most
+// one of these defined:
+//
+//  DSPFILTERS_KERNELS_SSE2
+//  DSPFILTERS_KERNELS_AVX2    (in a region compiled for AVX2)
+//  DSPFILTERS_KERNELS_AVX512  (in a region compiled for AVX-512)
+//  DSPFILTERS_KERNELS_NEON
+//
+// With none defined every entry is a reference template. A file that
+// includes it more than once gives each copy a namespace of its own. The
+// unnamed namespace keeps every copy's code apart, so the linker can't
+// merge an AVX2 kernel with the baseline one of the same name.
+//
+// The shuffles use 128 bit vectors on every set. AVX2 and AVX-512 widen
+// the element wise kernels and the conversions.
+//
+
+//------------------------------------------------------------------------------
+
+#if defined (DSPFILTERS_KERNELS_SSE2) || defined (DSPFILTERS_KERNELS_AVX2) || defined (DSPFILTERS_KERNELS_AVX512)
+
+struct Float4
+{
+  typedef __m128 V;
+  typedef float T;
+  enum { size = 4 };
+
+  static V load (const float* p) { return _mm_loadu_ps (p); }
+  static void store (float* p, V v) { _mm_storeu_ps (p, v); }
+  static V set1 (float x) { return _mm_set1_ps (x); }
+  static V lanes () { return _mm_setr_ps (0, 1, 2, 3); }
+  static V add (V a, V b) { return _mm_add_ps (a, b); }
+  static V sub (V a, V b) { return _mm_sub_ps (a, b); }
+  static V mul (V a, V b) { return _mm_mul_ps (a, b); }
+  static V abs (V v) { return _mm_andnot_ps (_mm_set1_ps (-0.f), v); }
+
+  // Reciprocal to at least 12 bits
+  static V rcp (V v) { return _mm_rcp_ps (v); }
+
+  // Four doubles rounded to float
+  static V loadDoubles (const double* p)
+  {
+    return _mm_movelh_ps (_mm_cvtpd_ps (_mm_loadu_pd (p)), _mm_cvtpd_ps (_mm_loadu_pd (p + 2)));
+  }
+
+  // lo = a0 b0 a1 b1, hi = a2 b2 a3 b3
+  static void zip (V a, V b, V& lo, V& hi)
+  {
+    lo = _mm_unpacklo_ps (a, b);
+    hi = _mm_unpackhi_ps (a, b);
+  }
+
+  // The inverse of zip
+  static void unzip (V lo, V hi, V& a, V& b)
+  {
+    a = _mm_shuffle_ps (lo, hi, _MM_SHUFFLE (2, 0, 2, 0));
+    b = _mm_shuffle_ps (lo, hi, _MM_SHUFFLE (3, 1, 3, 1));
+  }
+
+  static V reverse (V v) { return _mm_shuffle_ps (v, v, _MM_SHUFFLE (0, 1, 2, 3)); }
+
+  static void transpose (V& r0, V& r1, V& r2, V& r3) { _MM_TRANSPOSE4_PS (r0, r1, r2, r3); }
+};
+
+struct Double2
+{
+  typedef __m128d V;
+  typedef double T;
+  enum { size = 2 };
+
+  static V load (const double* p) { return _mm_loadu_pd (p); }
+  static void store (double* p, V v) { _mm_storeu_pd (p, v); }
+  static V set1 (double x) { return _mm_set1_pd (x); }
+  static V lanes () { return _mm_setr_pd (0, 1); }
+  static V add (V a, V b) { return _mm_add_pd (a, b); }
+  static V sub (V a, V b) { return _mm_sub_pd (a, b); }
+  static V mul (V a, V b) { return _mm_mul_pd (a, b); }
+
+  // Two floats widened to double
+  static V loadFloats (const float* p)
+  {
+    return _mm_cvtps_pd (_mm_castpd_ps (_mm_load_sd (reinterpret_cast<const double*> (p))));
+  }
+
+  // A 2x2 transpose, which is its own inverse
+  static void zip (V a, V b, V& lo, V& hi)
+  {
+    lo = _mm_unpacklo_pd (a, b);
+    hi = _mm_unpackhi_pd (a, b);
+  }
+
+  static void unzip (V lo, V hi, V& a, V& b) { zip (lo, hi, a, b); }
+
+  static V reverse (V v) { return _mm_shuffle_pd (v, v, 1); }
+};
+
+#define DSPFILTERS_KERNELS_FLOAT 1
+#define DSPFILTERS_KERNELS_DOUBLE 1
+
+#elif defined (DSPFILTERS_KERNELS_NEON)
+
+struct Float4
+{
+  typedef float32x4_t V;
+  typedef float T;
+  enum { size = 4 };
+
+  static V load (const float* p) { return vld1q_f32 (p); }
+  static void store (float* p, V v) { vst1q_f32 (p, v); }
+  static V set1 (float x) { return vdupq_n_f32 (x); }
+  static V lanes ()
+  {
+    const float x[4] = { 0, 1, 2, 3 };
+    return vld1q_f32 (x);
+  }
+  static V add (V a, V b) { return vaddq_f32 (a, b); }
+  static V sub (V a, V b) { return vsubq_f32 (a, b); }
+  static V mul (V a, V b) { return vmulq_f32 (a, b); }
+  static V abs (V v) { return vabsq_f32 (v); }
+
+  // Reciprocal to at least 12 bits, the estimate alone giving only 8
+  static V rcp (V v)
+  {
+    const V r = vrecpeq_f32 (v);
+    return vmulq_f32 (r, vrecpsq_f32 (v, r));
+  }
+
+#if DSPFILTERS_NEON_DOUBLE
+  static V loadDoubles (const double* p)
+  {
+    return vcombine_f32 (vcvt_f32_f64 (vld1q_f64 (p)), vcvt_f32_f64 (vld1q_f64 (p + 2)));
+  }
+#endif
+
+  static void zip (V a, V b, V& lo, V& hi)
+  {
+    const float32x4x2_t z = vzipq_f32 (a, b);
+    lo = z.val[0];
+    hi = z.val[1];
+  }
+
+  static void unzip (V lo, V hi, V& a, V& b)
+  {
+    const float32x4x2_t u = vuzpq_f32 (lo, hi);
+    a = u.val[0];
+    b = u.val[1];
+  }
+
+  static V reverse (V v)
+  {
+    const float32x4_t r = vrev64q_f32 (v);
+    return vcombine_f32 (vget_high_f32 (r), vget_low_f32 (r));
+  }
+
+  static void transpose (V& r0, V& r1, V& r2, V& r3)
+  {
+    const float32x4x2_t t01 = vtrnq_f32 (r0, r1);
+    const float32x4x2_t t23 = vtrnq_f32 (r2, r3);
+    r0 = vcombine_f32 (vget_low_f32 (t01.val[0]), vget_low_f32 (t23.val[0]));
+    r1 = vcombine_f32 (vget_low_f32 (t01.val[1]), vget_low_f32 (t23.val[1]));
+    r2 = vcombine_f32 (vget_high_f32 (t01.val[0]), vget_high_f32 (t23.val[0]));
+    r3 = vcombine_f32 (vget_high_f32 (t01.val[1]), vget_high_f32 (t23.val[1]));
+  }
+};
+
+#define DSPFILTERS_KERNELS_FLOAT 1
+
+#if DSPFILTERS_NEON_DOUBLE
+
+struct Double2
+{
+  typedef float64x2_t V;
+  typedef double T;
+  enum { size = 2 };
+
+  static V load (const double* p) { return vld1q_f64 (p); }
+  static void store (double* p, V v) { vst1q_f64 (p, v); }
+  static V set1 (double x) { return vdupq_n_f64 (x); }
+  static V lanes ()
+  {
+    const double x[2] = { 0, 1 };
+    return vld1q_f64 (x);
+  }
+  static V add (V a, V b) { return vaddq_f64 (a, b); }
+  static V sub (V a, V b) { return vsubq_f64 (a, b); }
+  static V mul (V a, V b) { return vmulq_f64 (a, b); }
+
+  static V loadFloats (const float* p) { return vcvt_f64_f32 (vld1_f32 (p)); }
+
+  static void zip (V a, V b, V& lo, V& hi)
+  {
+    lo = vzip1q_f64 (a, b);
+    hi = vzip2q_f64 (a, b);
+  }
+
+  static void unzip (V lo, V hi, V& a, V& b) { zip (lo, hi, a, b); }
+
+  static V reverse (V v) { return vextq_f64 (v, v, 1); }
+};
+
+#define DSPFILTERS_KERNELS_DOUBLE 1
+
+#endif
+
+#endif
+
+//------------------------------------------------------------------------------
+
+//
+// Vectors for the element wise kernels, as wide as the set allows
+//
+
+#if defined (DSPFILTERS_KERNELS_AVX2)
+
+struct Float8
+{
+  typedef __m256 V;
+  typedef float T;
+  enum { size = 8 };
+
+  static V load (const float* p) { return _mm256_loadu_ps (p); }
+  static void store (float* p, V v) { _mm256_storeu_ps (p, v); }
+  static V set1 (float x) { return _mm256_set1_ps (x); }
+  static V lanes () { return _mm256_setr_ps (0, 1, 2, 3, 4, 5, 6, 7); }
+  static V add (V a, V b) { return _mm256_add_ps (a, b); }
+  static V sub (V a, V b) { return _mm256_sub_ps (a, b); }
+  static V mul (V a, V b) { return _mm256_mul_ps (a, b); }
+  static V abs (V v) { return _mm256_andnot_ps (_mm256_set1_ps (-0.f), v); }
+  static V rcp (V v) { return _mm256_rcp_ps (v); }
+
+  static V loadDoubles (const double* p)
+  {
+    const __m128 lo = _mm256_cvtpd_ps (_mm256_loadu_pd (p));
+    const __m128 hi = _mm256_cvtpd_ps (_mm256_loadu_pd (p + 4));
+    return _mm256_insertf128_ps (_mm256_castps128_ps256 (lo), hi, 1);
+  }
+};
+
+struct Double4
+{
+  typedef __m256d V;
+  typedef double T;
+  enum { size = 4 };
+
+  static V load (const double* p) { return _mm256_loadu_pd (p); }
+  static void store (double* p, V v) { _mm256_storeu_pd (p, v); }
+  static V set1 (double x) { return _mm256_set1_pd (x); }
+  static V lanes () { return _mm256_setr_pd (0, 1, 2, 3); }
+  static V add (V a, V b) { return _mm256_add_pd (a, b); }
+  static V sub (V a, V b) { return _mm256_sub_pd (a, b); }
+  static V mul (V a, V b) { return _mm256_mul_pd (a, b); }
+
+  static V loadFloats (const float* p) { return _mm256_cvtps_pd (_mm_loadu_ps (p)); }
+};
+
+typedef Float8 FloatV;
+typedef Double4 DoubleV;
+
+#elif defined (DSPFILTERS_KERNELS_AVX512)
+
+struct Float16
+{
+  typedef __m512 V;
+  typedef float T;
+  enum { size = 16 };
+
+  static V load (const float* p) { return _mm512_loadu_ps (p); }
+  static void store (float* p, V v) { _mm512_storeu_ps (p, v); }
+  static V set1 (float x) { return _mm512_set1_ps (x); }
+  static V lanes () { return _mm512_setr_ps (0, 1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11, 12, 13, 14, 15); }
+  static V add (V a, V b) { return _mm512_add_ps (a, b); }
+  static V sub (V a, V b) { return _mm512_sub_ps (a, b); }
+  static V mul (V a, V b) { return _mm512_mul_ps (a, b); }
+  static V abs (V v) { return _mm512_abs_ps (v); }
+  static V rcp (V v) { return _mm512_rcp14_ps (v); }
+
+  static V loadDoubles (const double* p)
+  {
+    const __m256 lo = _mm512_cvtpd_ps (_mm512_loadu_pd (p));
+    const __m256 hi = _mm512_cvtpd_ps (_mm512_loadu_pd (p + 8));
+    return _mm512_castpd_ps (_mm512_insertf64x4 (_mm512_castps_pd (_mm512_castps256_ps512 (lo)),
+                                                 _mm256_castps_pd (hi), 1));
+  }
+};
+
+struct Double8
+{
+  typedef __m512d V;
+  typedef double T;
+  enum { size = 8 };
+
+  static V load (const double* p) { return _mm512_loadu_pd (p); }
+  static void store (double* p, V v) { _mm512_storeu_pd (p, v); }
+  static V set1 (double x) { return _mm512_set1_pd (x); }
+  static V lanes () { return _mm512_setr_pd (0, 1, 2, 3, 4, 5, 6, 7); }
+  static V add (V a, V b) { return _mm512_add_pd (a, b); }
+  static V sub (V a, V b) { return _mm512_sub_pd (a, b); }
+  static V mul (V a, V b) { return _mm512_mul_pd (a, b); }
+
+  static V loadFloats (const float* p) { return _mm512_cvtps_pd (_mm256_loadu_ps (p)); }
+};
+
+typedef Float16 FloatV;
+typedef Double8 DoubleV;
+
+#else
+
+#if DSPFILTERS_KERNELS_FLOAT
+typedef Float4 FloatV;
+#endif
+#if DSPFILTERS_KERNELS_DOUBLE
+typedef Double2 DoubleV;
+#endif
+
+#endif
+
+//------------------------------------------------------------------------------
+
+//
+// Kernels, each followed by a scalar loop for the samples that don't fill
+// a vector. The arithmetic is the same as in the reference templates.
+//
+
+template <class Vec>
+void addKernel (int samples, typename Vec::T* dest, typename Vec::T const* src)
+{
+  int i = 0;
+  for (; i <= samples - Vec::size; i += Vec::size)
+    Vec::store (dest + i, Vec::add (Vec::load (dest + i), Vec::load (src + i)));
+
+  for (; i < samples; ++i)
+    dest[i] += src[i];
+}
+
+template <class Vec>
+void multiplyKernel (int samples, typename Vec::T* dest, typename Vec::T factor)
+{
+  const typename Vec::V f = Vec::set1 (factor);
+
+  int i = 0;
+  for (; i <= samples - Vec::size; i += Vec::size)
+    Vec::store (dest + i, Vec::mul (Vec::load (dest + i), f));
+
+  for (; i < samples; ++i)
+    dest[i] = dest[i] * factor;
+}
+
+template <class Vec>
+void toMonoKernel (int samples,
+                   typename Vec::T* dest,
+                   typename Vec::T const* left,
+                   typename Vec::T const* right)
+{
+  typedef typename Vec::T T;
+  const T scale = T(0.70710678118654752440084436210485);
+  const typename Vec::V s = Vec::set1 (scale);
+
+  int i = 0;
+  for (; i <= samples - Vec::size; i += Vec::size)
+    Vec::store (dest + i, Vec::mul (Vec::add (Vec::load (left + i), Vec::load (right + i)), s));
+
+  for (; i < samples; ++i)
+    dest[i] = (left[i] + right[i]) * scale;
+}
+
+// Ramp of the lanes from sample i on, start + (i + lane) * dt. The lane
+// indices are exact, so this matches the scalar formula.
+template <class Vec>
+typename Vec::V rampKernel (int i, typename Vec::V start, typename Vec::V dt)
+{
+  typedef typename Vec::T T;
+  return Vec::add (start, Vec::mul (Vec::add (Vec::set1 (T(i)), Vec::lanes ()), dt));
+}
+
+template <class Vec>
+void fadeKernel (int samples, typename Vec::T* dest, typename Vec::T start, typename Vec::T end)
+{
+  typedef typename Vec::T T;
+  const T dt = (end - start) / samples;
+  const typename Vec::V vstart = Vec::set1 (start);
+  const typename Vec::V vdt = Vec::set1 (dt);
+
+  int i = 0;
+  for (; i <= samples - Vec::size; i += Vec::size)
+    Vec::store (dest + i, Vec::mul (Vec::load (dest + i), rampKernel <Vec> (i, vstart, vdt)));
+
+  for (; i < samples; ++i)
+    dest[i] *= start + T(i) * dt;
+}
+
+template <class Vec>
+void crossFadeKernel (int samples,
+                      typename Vec::T* dest,
+                      typename Vec::T const* src,
+                      typename Vec::T start,
+                      typename Vec::T end)
+{
+  typedef typename Vec::T T;
+  const T dt = (end - start) / samples;
+  const typename Vec::V vstart = Vec::set1 (start);
+  const typename Vec::V vdt = Vec::set1 (dt);
+
+  int i = 0;
+  for (; i <= samples - Vec::size; i += Vec::size)
+  {
+    const typename Vec::V d = Vec::load (dest + i);
+    const typename Vec::V t = rampKernel <Vec> (i, vstart, vdt);
+    Vec::store (dest + i, Vec::add (d, Vec::mul (t, Vec::sub (Vec::load (src + i), d))));
+  }
+
+  for (; i < samples; ++i)
+    dest[i] = dest[i] + (start + T(i) * dt) * (src[i] - dest[i]);
+}
+
+// Soft clip, dividing through a reciprocal estimate. One Newton step takes
+// the estimate from 12 bits to about 23. The denominator is at least one,
+// so the estimate never meets a zero or a denormal.
+template <class Vec>
+void saturateKernel (int samples, float* dest, float amount)
+{
+  typedef typename Vec::V V;
+  const V k = Vec::set1 (amount);
+  const V gain = Vec::set1 (1 + amount);
+  const V one = Vec::set1 (1);
+  const V two = Vec::set1 (2);
+
+  int i = 0;
+  for (; i <= samples - Vec::size; i += Vec::size)
+  {
+    const V x = Vec::load (dest + i);
+    const V d = Vec::add (one, Vec::mul (k, Vec::abs (x)));
+    V r = Vec::rcp (d);
+    r = Vec::mul (r, Vec::sub (two, Vec::mul (d, r)));
+    Vec::store (dest + i, Vec::mul (Vec::mul (gain, x), r));
+  }
+
+  for (; i < samples; ++i)
+    dest[i] = (1 + amount) * dest[i] / (1 + amount * std::abs (dest[i]));
+}
+
+template <class Vec>
+void reverseKernel (int samples, typename Vec::T* dest, typename Vec::T const* src)
+{
+  int i = 0;
+  for (; i <= samples - Vec::size; i += Vec::size)
+    Vec::store (dest + i, Vec::reverse (Vec::load (src + samples - Vec::size - i)));
+
+  for (; i < samples; ++i)
+    dest[i] = src[samples - 1 - i];
+}
+
+template <class Vec>
+void interleave2Kernel (int samples, typename Vec::T* dest, typename Vec::T const* const* src)
+{
+  const typename Vec::T* left = src[0];
+  const typename Vec::T* right = src[1];
+
+  int i = 0;
+  for (; i <= samples - Vec::size; i += Vec::size)
+  {
+    typename Vec::V lo, hi;
+    Vec::zip (Vec::load (left + i), Vec::load (right + i), lo, hi);
+    Vec::store (dest + 2 * i, lo);
+    Vec::store (dest + 2 * i + Vec::size, hi);
+  }
+
+  for (; i < samples; ++i)
+  {
+    dest[2 * i] = left[i];
+    dest[2 * i + 1] = right[i];
+  }
+}
+
+template <class Vec>
+void deinterleave2Kernel (int samples, typename Vec::T* const* dest, typename Vec::T const* src)
+{
+  typename Vec::T* left = dest[0];
+  typename Vec::T* right = dest[1];
+
+  int i = 0;
+  for (; i <= samples - Vec::size; i += Vec::size)
+  {
+    typename Vec::V l, r;
+    Vec::unzip (Vec::load (src + 2 * i), Vec::load (src + 2 * i + Vec::size), l, r);
+    Vec::store (left + i, l);
+    Vec::store (right + i, r);
+  }
+
+  for (; i < samples; ++i)
+  {
+    left[i] = src[2 * i];
+    right[i] = src[2 * i + 1];
+  }
+}
+
+#if DSPFILTERS_KERNELS_FLOAT
+
+// Eight channels, four frames at a time as two 4x4 transposes
+void interleave8Kernel (int samples, float* dest, float const* const* src)
+{
+  int i = 0;
+  for (; i <= samples - 4; i += 4)
+  {
+    Float4::V v[8];
+    for (int c = 0; c < 8; ++c)
+      v[c] = Float4::load (src[c] + i);
+
+    Float4::transpose (v[0], v[1], v[2], v[3]);
+    Float4::transpose (v[4], v[5], v[6], v[7]);
+
+    for (int f = 0; f < 4; ++f)
+    {
+      Float4::store (dest + 8 * (i + f), v[f]);
+      Float4::store (dest + 8 * (i + f) + 4, v[4 + f]);
+    }
+  }
+
+  for (; i < samples; ++i)
+    for (int c = 0; c < 8; ++c)
+      dest[8 * i + c] = src[c][i];
+}
+
+void deinterleave8Kernel (int samples, float* const* dest, float const* src)
+{
+  int i = 0;
+  for (; i <= samples - 4; i += 4)
+  {
+    Float4::V v[8];
+    for (int f = 0; f < 4; ++f)
+    {
+      v[f] = Float4::load (src + 8 * (i + f));
+      v[4 + f] = Float4::load (src + 8 * (i + f) + 4);
+    }
+
+    Float4::transpose (v[0], v[1], v[2], v[3]);
+    Float4::transpose (v[4], v[5], v[6], v[7]);
+
+    for (int c = 0; c < 8; ++c)
+      Float4::store (dest[c] + i, v[c]);
+  }
+
+  for (; i < samples; ++i)
+    for (int c = 0; c < 8; ++c)
+      dest[c][i] = src[8 * i + c];
+}
+
+#endif
+
+#if DSPFILTERS_KERNELS_DOUBLE
+
+// Eight channels, two frames at a time as four 2x2 transposes
+void interleave8Kernel (int samples, double* dest, double const* const* src)
+{
+  int i = 0;
+  for (; i <= samples - 2; i += 2)
+  {
+    for (int c = 0; c < 8; c += 2)
+    {
+      Double2::V first, second;
+      Double2::zip (Double2::load (src[c] + i), Double2::load (src[c + 1] + i), first, second);
+      Double2::store (dest + 8 * i + c, first);
+      Double2::store (dest + 8 * (i + 1) + c, second);
+    }
+  }
+
+  for (; i < samples; ++i)
+    for (int c = 0; c < 8; ++c)
+      dest[8 * i + c] = src[c][i];
+}
+
+void deinterleave8Kernel (int samples, double* const* dest, double const* src)
+{
+  int i = 0;
+  for (; i <= samples - 2; i += 2)
+  {
+    for (int c = 0; c < 8; c += 2)
+    {
+      Double2::V a, b;
+      Double2::unzip (Double2::load (src + 8 * i + c), Double2::load (src + 8 * (i + 1) + c), a, b);
+      Double2::store (dest[c] + i, a);
+      Double2::store (dest[c + 1] + i, b);
+    }
+  }
+
+  for (; i < samples; ++i)
+    for (int c = 0; c < 8; ++c)
+      dest[c][i] = src[8 * i + c];
+}
+
+// Conversions, rounding to float per element as the scalar loops do
+void copyKernel (int samples, double* dest, float const* src)
+{
+  int i = 0;
+  for (; i <= samples - DoubleV::size; i += DoubleV::size)
+    DoubleV::store (dest + i, DoubleV::loadFloats (src + i));
+
+  for (; i < samples; ++i)
+    dest[i] = src[i];
+}
+
+void copyKernel (int samples, float* dest, double const* src)
+{
+  int i = 0;
+  for (; i <= samples - FloatV::size; i += FloatV::size)
+    FloatV::store (dest + i, FloatV::loadDoubles (src + i));
+
+  for (; i < samples; ++i)
+    dest[i] = static_cast<float> (src[i]);
+}
+
+void addKernel (int samples, double* dest, float const* src)
+{
+  int i = 0;
+  for (; i <= samples - DoubleV::size; i += DoubleV::size)
+    DoubleV::store (dest + i, DoubleV::add (DoubleV::load (dest + i), DoubleV::loadFloats (src + i)));
+
+  for (; i < samples; ++i)
+    dest[i] += static_cast<double> (src[i]);
+}
+
+void addKernel (int samples, float* dest, double const* src)
+{
+  int i = 0;
+  for (; i <= samples - FloatV::size; i += FloatV::size)
+    FloatV::store (dest + i, FloatV::add (FloatV::load (dest + i), FloatV::loadDoubles (src + i)));
+
+  for (; i < samples; ++i)
+    dest[i] += static_cast<float> (src[i]);
+}
+
+#endif
+
+//------------------------------------------------------------------------------
+
+//
+// The table, with the reference templates wherever the set has no vector
+// type for the sample type
+//
+
+#if DSPFILTERS_KERNELS_FLOAT
+#  define DSPFILTERS_FLOAT_KERNEL(call, reference) call
+#else
+#  define DSPFILTERS_FLOAT_KERNEL(call, reference) reference
+#endif
+
+#if DSPFILTERS_KERNELS_DOUBLE
+#  define DSPFILTERS_DOUBLE_KERNEL(call, reference) call
+#else
+#  define DSPFILTERS_DOUBLE_KERNEL(call, reference) reference
+#endif
+
+void addFloat (int samples, float* dest, float const* src)
+{
+  DSPFILTERS_FLOAT_KERNEL (addKernel <FloatV> (samples, dest, src),
+                           (add<float, float> (samples, dest, src)));
+}
+
+void addDouble (int samples, double* dest, double const* src)
+{
+  DSPFILTERS_DOUBLE_KERNEL (addKernel <DoubleV> (samples, dest, src),
+                            (add<double, double> (samples, dest, src)));
+}
+
+void addFloatToDouble (int samples, double* dest, float const* src)
+{
+  DSPFILTERS_DOUBLE_KERNEL (addKernel (samples, dest, src),
+                            (add<double, float> (samples, dest, src)));
+}
+
+void addDoubleToFloat (int samples, float* dest, double const* src)
+{
+  DSPFILTERS_DOUBLE_KERNEL (addKernel (samples, dest, src),
+                            (add<float, double> (samples, dest, src)));
+}
+
+void copyFloatToDouble (int samples, double* dest, float const* src)
+{
+  DSPFILTERS_DOUBLE_KERNEL (copyKernel (samples, dest, src),
+                            (copy<double, float> (samples, dest, src)));
+}
+
+void copyDoubleToFloat (int samples, float* dest, double const* src)
+{
+  DSPFILTERS_DOUBLE_KERNEL (copyKernel (samples, dest, src),
+                            (copy<float, double> (samples, dest, src)));
+}
+
+void deinterleave2Float (int samples, float* const* dest, float const* src)
+{
+  DSPFILTERS_FLOAT_KERNEL (deinterleave2Kernel <Float4> (samples, dest, src),
+                           (deinterleave<float, float> (2, samples, dest, src)));
+}
+
+void deinterleave2Double (int samples, double* const* dest, double const* src)
+{
+  DSPFILTERS_DOUBLE_KERNEL (deinterleave2Kernel <Double2> (samples, dest, src),
+                            (deinterleave<double, double> (2, samples, dest, src)));
+}
+
+void deinterleave8Float (int samples, float* const* dest, float const* src)
+{
+  DSPFILTERS_FLOAT_KERNEL (deinterleave8Kernel (samples, dest, src),
+                           (deinterleave<float, float> (8, samples, dest, src)));
+}
+
+void deinterleave8Double (int samples, double* const* dest, double const* src)
+{
+  DSPFILTERS_DOUBLE_KERNEL (deinterleave8Kernel (samples, dest, src),
+                            (deinterleave<double, double> (8, samples, dest, src)));
+}
+
+void fadeFloat (int samples, float* dest, float start, float end)
+{
+  DSPFILTERS_FLOAT_KERNEL (fadeKernel <FloatV> (samples, dest, start, end),
+                           (fade<float, float> (samples, dest, start, end)));
+}
+
+void fadeDouble (int samples, double* dest, double start, double end)
+{
+  DSPFILTERS_DOUBLE_KERNEL (fadeKernel <DoubleV> (samples, dest, start, end),
+                            (fade<double, double> (samples, dest, start, end)));
+}
+
+void crossFadeFloat (int samples, float* dest, float const* src, float start, float end)
+{
+  DSPFILTERS_FLOAT_KERNEL (crossFadeKernel <FloatV> (samples, dest, src, start, end),
+                           (fade<float, float, float> (samples, dest, src, start, end)));
+}
+
+void crossFadeDouble (int samples, double* dest, double const* src, double start, double end)
+{
+  DSPFILTERS_DOUBLE_KERNEL (crossFadeKernel <DoubleV> (samples, dest, src, start, end),
+                            (fade<double, double, double> (samples, dest, src, start, end)));
+}
+
+void interleave2Float (int samples, float* dest, float const* const* src)
+{
+  DSPFILTERS_FLOAT_KERNEL (interleave2Kernel <Float4> (samples, dest, src),
+                           (interleave<float, float> (2, static_cast<size_t> (samples), dest, src)));
+}
+
+void interleave2Double (int samples, double* dest, double const* const* src)
+{
+  DSPFILTERS_DOUBLE_KERNEL (interleave2Kernel <Double2> (samples, dest, src),
+                            (interleave<double, double> (2, static_cast<size_t> (samples), dest, src)));
+}
+
+void interleave8Float (int samples, float* dest, float const* const* src)
+{
+  DSPFILTERS_FLOAT_KERNEL (interleave8Kernel (samples, dest, src),
+                           (interleave<float, float> (8, static_cast<size_t> (samples), dest, src)));
+}
+
+void interleave8Double (int samples, double* dest, double const* const* src)
+{
+  DSPFILTERS_DOUBLE_KERNEL (interleave8Kernel (samples, dest, src),
+                            (interleave<double, double> (8, static_cast<size_t> (samples), dest, src)));
+}
+
+void multiplyFloat (int samples, float* dest, float factor)
+{
+  DSPFILTERS_FLOAT_KERNEL (multiplyKernel <FloatV> (samples, dest, factor),
+                           (multiply<float, float> (samples, dest, factor)));
+}
+
+void multiplyDouble (int samples, double* dest, double factor)
+{
+  DSPFILTERS_DOUBLE_KERNEL (multiplyKernel <DoubleV> (samples, dest, factor),
+                            (multiply<double, double> (samples, dest, factor)));
+}
+
+void reverseFloat (int samples, float* dest, float const* src)
+{
+  DSPFILTERS_FLOAT_KERNEL (reverseKernel <Float4> (samples, dest, src),
+                           (reverse<float, float> (samples, dest, src)));
+}
+
+void reverseDouble (int samples, double* dest, double const* src)
+{
+  DSPFILTERS_DOUBLE_KERNEL (reverseKernel <Double2> (samples, dest, src),
+                            (reverse<double, double> (samples, dest, src)));
+}
+
+void saturateFloat (int samples, float* dest, float amount)
+{
+  DSPFILTERS_FLOAT_KERNEL (saturateKernel <FloatV> (samples, dest, amount),
+                           (saturate<float> (samples, dest, amount)));
+}
+
+void toMonoFloat (int samples, float* dest, float const* left, float const* right)
+{
+  DSPFILTERS_FLOAT_KERNEL (toMonoKernel <FloatV> (samples, dest, left, right),
+                           (to_mono<float> (samples, dest, left, right)));
+}
+
+void toMonoDouble (int samples, double* dest, double const* left, double const* right)
+{
+  DSPFILTERS_DOUBLE_KERNEL (toMonoKernel <DoubleV> (samples, dest, left, right),
+                            (to_mono<double> (samples, dest, left, right)));
+}
+
+const UtilityKernels kernels =
+{
+  addFloat,
+  addDouble,
+  addFloatToDouble,
+  addDoubleToFloat,
+
+  copyFloatToDouble,
+  copyDoubleToFloat,
+
+  deinterleave2Float,
+  deinterleave2Double,
+  deinterleave8Float,
+  deinterleave8Double,
+
+  fadeFloat,
+  fadeDouble,
+  crossFadeFloat,
+  crossFadeDouble,
+
+  interleave2Float,
+  interleave2Double,
+  interleave8Float,
+  interleave8Double,
+
+  multiplyFloat,
+  multiplyDouble,
+
+  reverseFloat,
+  reverseDouble,
+
+  saturateFloat,
+
+  toMonoFloat,
+  toMonoDouble
+};
+
+#undef DSPFILTERS_FLOAT_KERNEL
+#undef DSPFILTERS_DOUBLE_KERNEL
+#undef DSPFILTERS_KERNELS_FLOAT
+#undef DSPFILTERS_KERNELS_DOUBLE
@@ -35,6 +35,7 @@ THE SOFTWARE.
 
 #include "DspFilters/Common.h"
 #include "DspFilters/Bessel.h"
+#include "DspFilters/PrototypeCache.h"
 #include "DspFilters/RootFinder.h"
 
 namespace Dsp {
@@ -78,6 +79,10 @@ void AnalogLowPass::design (int numPoles,
 
     reset ();
 
+    if (PrototypeCache::find (PrototypeCache::besselLowPass,
+                              numPoles, 0, 0, *this))
+      return;
+
     RootFinderBase& solver (w->roots);
     for (int i = 0; i < numPoles + 1; ++i)
       solver.coef()[i] = reversebessel (i, numPoles);
@@ -92,6 +97,9 @@ void AnalogLowPass::design (int numPoles,
 
     if (numPoles & 1)
       add (solver.root()[pairs].real(), infinity());
+
+    PrototypeCache::add (PrototypeCache::besselLowPass,
+                         numPoles, 0, 0, *this);
   }
 }
 
@@ -115,6 +123,10 @@ void AnalogLowShelf::design (int numPoles,
 
     reset ();
 
+    if (PrototypeCache::find (PrototypeCache::besselLowShelf,
+                              numPoles, gainDb, 0, *this))
+      return;
+
     const double G = pow (10., gainDb / 20) - 1;
 
     RootFinderBase& poles (w->roots);
@@ -139,6 +151,9 @@ void AnalogLowShelf::design (int numPoles,
 
     if (numPoles & 1)
       add (poles.root()[pairs].real(), zeros.root()[pairs].real());
+
+    PrototypeCache::add (PrototypeCache::besselLowShelf,
+                         numPoles, gainDb, 0, *this);
   }
 }
 
@@ -108,6 +108,30 @@ complex_t BiquadBase::response (double normalizedFrequency) const
   return ch / cbot;
 }
 
+void BiquadBase::response (const double* normalizedFrequencies,
+                           complex_t* out,
+                           int numFrequencies) const
+{
+  ResponseEvaluator (normalizedFrequencies, numFrequencies).evaluate (
+    this, 1, out, 0, 0);
+}
+
+void BiquadBase::magnitudeResponse (const double* normalizedFrequencies,
+                                    double* out,
+                                    int numFrequencies) const
+{
+  ResponseEvaluator (normalizedFrequencies, numFrequencies).evaluate (
+    this, 1, 0, out, 0);
+}
+
+void BiquadBase::groupDelay (const double* normalizedFrequencies,
+                             double* out,
+                             int numFrequencies) const
+{
+  ResponseEvaluator (normalizedFrequencies, numFrequencies).evaluate (
+    this, 1, 0, 0, out);
+}
+
 std::vector<PoleZeroPair> BiquadBase::getPoleZeros () const
 {
   std::vector<PoleZeroPair> vpz;
@@ -233,4 +257,178 @@ Biquad::Biquad (const BiquadPoleState& bps)
 
 //------------------------------------------------------------------------------
 
+//------------------------------------------------------------------------------
+
+ResponseEvaluator::ResponseEvaluator (const double* normalizedFrequencies,
+                                      int numFrequencies)
+  : m_frequencies (normalizedFrequencies)
+  , m_numFrequencies (numFrequencies)
+  , m_isUniform (false)
+  , m_step (0)
+{
+  if (numFrequencies > 2)
+  {
+    const double first = normalizedFrequencies[0];
+    m_step = (normalizedFrequencies[numFrequencies - 1] - first) / (numFrequencies - 1);
+
+    // Only grids that match the linear spacing to rounding error count
+    const double tolerance = 1e-12 * (std::abs (first) + std::abs (m_step) * numFrequencies);
+    m_isUniform = true;
+    for (int i = 1; i < numFrequencies && m_isUniform; ++i)
+      m_isUniform = std::abs (normalizedFrequencies[i] - (first + i * m_step)) <= tolerance;
+  }
+}
+
+void ResponseEvaluator::beginChunk (int start, int count,
+                                    bool wantResponse, bool wantMagnitude, bool wantGroupDelay)
+{
+  m_count = count;
+  m_wantResponse = wantResponse;
+  m_wantMagnitude = wantMagnitude;
+  m_wantGroupDelay = wantGroupDelay;
+
+  const double* f = m_frequencies + start;
+
+  if (m_isUniform)
+  {
+    const double w = 2 * doublePi * f[0];
+    const double dw = 2 * doublePi * m_step;
+    const double cd = cos (dw);
+    const double sd = sin (dw);
+    double c = cos (w);
+    double s = sin (w);
+
+    for (int i = 0; i < count; ++i)
+    {
+      m_cos1[i] = c;
+      m_sin1[i] = s;
+
+      const double cn = c * cd - s * sd;
+      s = s * cd + c * sd;
+      c = cn;
+    }
+  }
+  else
+  {
+    for (int i = 0; i < count; ++i)
+    {
+      const double w = 2 * doublePi * f[i];
+      m_cos1[i] = cos (w);
+      m_sin1[i] = sin (w);
+    }
+  }
+
+  for (int i = 0; i < count; ++i)
+  {
+    const double c = m_cos1[i];
+    const double s = m_sin1[i];
+    m_cos2[i] = c * c - s * s;
+    m_sin2[i] = 2 * s * c;
+
+    m_numRe[i] = 1;
+    m_numIm[i] = 0;
+    m_denRe[i] = 1;
+    m_denIm[i] = 0;
+    m_numMag[i] = 1;
+    m_denMag[i] = 1;
+    m_delay[i] = 0;
+  }
+}
+
+void ResponseEvaluator::addSection (const BiquadBase& s)
+{
+  // The stored coefficients are already normalized by a0
+  const double b0 = s.m_b0;
+  const double b1 = s.m_b1;
+  const double b2 = s.m_b2;
+  const double a1 = s.m_a1;
+  const double a2 = s.m_a2;
+  const int count = m_count;
+
+  // B = b0 + b1 z^-1 + b2 z^-2, A = 1 + a1 z^-1 + a2 z^-2, with z^-k = cos kw - j sin kw
+  if (m_wantResponse)
+  {
+    for (int i = 0; i < count; ++i)
+    {
+      const double bRe = b0 + b1 * m_cos1[i] + b2 * m_cos2[i];
+      const double bIm = -(b1 * m_sin1[i] + b2 * m_sin2[i]);
+      const double aRe = 1 + a1 * m_cos1[i] + a2 * m_cos2[i];
+      const double aIm = -(a1 * m_sin1[i] + a2 * m_sin2[i]);
+
+      const double nRe = m_numRe[i] * bRe - m_numIm[i] * bIm;
+      m_numIm[i] = m_numRe[i] * bIm + m_numIm[i] * bRe;
+      m_numRe[i] = nRe;
+
+      const double dRe = m_denRe[i] * aRe - m_denIm[i] * aIm;
+      m_denIm[i] = m_denRe[i] * aIm + m_denIm[i] * aRe;
+      m_denRe[i] = dRe;
+    }
+  }
+
+  if (m_wantMagnitude)
+  {
+    for (int i = 0; i < count; ++i)
+    {
+      const double bRe = b0 + b1 * m_cos1[i] + b2 * m_cos2[i];
+      const double bIm = b1 * m_sin1[i] + b2 * m_sin2[i];
+      const double aRe = 1 + a1 * m_cos1[i] + a2 * m_cos2[i];
+      const double aIm = a1 * m_sin1[i] + a2 * m_sin2[i];
+
+      m_numMag[i] *= bRe * bRe + bIm * bIm;
+      m_denMag[i] *= aRe * aRe + aIm * aIm;
+    }
+  }
+
+  // The group delay of a polynomial P in z^-1 is Re (sum k p_k z^-k / P)
+  if (m_wantGroupDelay)
+  {
+    for (int i = 0; i < count; ++i)
+    {
+      const double bRe = b0 + b1 * m_cos1[i] + b2 * m_cos2[i];
+      const double bIm = -(b1 * m_sin1[i] + b2 * m_sin2[i]);
+      const double kbRe = b1 * m_cos1[i] + 2 * b2 * m_cos2[i];
+      const double kbIm = -(b1 * m_sin1[i] + 2 * b2 * m_sin2[i]);
+
+      const double aRe = 1 + a1 * m_cos1[i] + a2 * m_cos2[i];
+      const double aIm = -(a1 * m_sin1[i] + a2 * m_sin2[i]);
+      const double kaRe = a1 * m_cos1[i] + 2 * a2 * m_cos2[i];
+      const double kaIm = -(a1 * m_sin1[i] + 2 * a2 * m_sin2[i]);
+
+      m_delay[i] += (kbRe * bRe + kbIm * bIm) / (bRe * bRe + bIm * bIm)
+                  - (kaRe * aRe + kaIm * aIm) / (aRe * aRe + aIm * aIm);
+    }
+  }
+}
+
+void ResponseEvaluator::endChunk (int start,
+                                  complex_t* response, double* magnitude, double* groupDelay)
+{
+  const int count = m_count;
+
+  if (response)
+  {
+    complex_t* out = response + start;
+    for (int i = 0; i < count; ++i)
+    {
+      const double scale = 1 / (m_denRe[i] * m_denRe[i] + m_denIm[i] * m_denIm[i]);
+      out[i] = complex_t ((m_numRe[i] * m_denRe[i] + m_numIm[i] * m_denIm[i]) * scale,
+                          (m_numIm[i] * m_denRe[i] - m_numRe[i] * m_denIm[i]) * scale);
+    }
+  }
+
+  if (magnitude)
+  {
+    double* out = magnitude + start;
+    for (int i = 0; i < count; ++i)
+      out[i] = sqrt (m_numMag[i] / m_denMag[i]);
+  }
+
+  if (groupDelay)
+  {
+    double* out = groupDelay + start;
+    for (int i = 0; i < count; ++i)
+      out[i] = m_delay[i];
+  }
+}
+
 }
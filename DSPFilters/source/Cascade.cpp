@@ -76,6 +76,30 @@ complex_t Cascade::response (double normalizedFrequency) const
   return ch / cbot;
 }
 
+void Cascade::response (const double* normalizedFrequencies,
+                        complex_t* out,
+                        int numFrequencies) const
+{
+  ResponseEvaluator (normalizedFrequencies, numFrequencies).evaluate (
+    m_stageArray, m_numStages, out, 0, 0);
+}
+
+void Cascade::magnitudeResponse (const double* normalizedFrequencies,
+                                 double* out,
+                                 int numFrequencies) const
+{
+  ResponseEvaluator (normalizedFrequencies, numFrequencies).evaluate (
+    m_stageArray, m_numStages, 0, out, 0);
+}
+
+void Cascade::groupDelay (const double* normalizedFrequencies,
+                          double* out,
+                          int numFrequencies) const
+{
+  ResponseEvaluator (normalizedFrequencies, numFrequencies).evaluate (
+    m_stageArray, m_numStages, 0, 0, out);
+}
+
 std::vector<PoleZeroPair> Cascade::getPoleZeros () const
 {
   std::vector<PoleZeroPair> vpz;
@@ -110,8 +134,11 @@ void Cascade::setLayout (const LayoutBase& proto)
   for (int i = 0; i < m_numStages; ++i, ++stage)
     stage->setPoleZeroPair (proto[i]);
   
-  applyScale (proto.getNormalGain() /
-              std::abs (response (proto.getNormalW() / (2 * doublePi))));
+  const double normalFrequency = proto.getNormalW() / (2 * doublePi);
+  double normalMagnitude;
+  magnitudeResponse (&normalFrequency, &normalMagnitude, 1);
+
+  applyScale (proto.getNormalGain() / normalMagnitude);
 }
 
 }
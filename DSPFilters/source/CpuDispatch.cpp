@@ -0,0 +1,219 @@
+/*******************************************************************************
+
+"A Collection of Useful C++ Classes for Digital Signal Processing"
+ By Vincent Falco
+
+Official project location:
+http://code.google.com/p/dspfilterscpp/
+
+See Documentation.cpp for contact information, notes, and bibliography.
+
+--------------------------------------------------------------------------------
+
+License: MIT License (http://www.opensource.org/licenses/mit-license.php)
+Copyright (c) 2009 by Vincent Falco
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+
+*******************************************************************************/
+
+
+#include "DspFilters/Common.h"
+#include "DspFilters/CpuDispatch.h"
+
+#include <atomic>
+
+#if DSPFILTERS_X86
+#  if defined (_MSC_VER)
+#    include <intrin.h>
+#  else
+#    include <cpuid.h>
+#  endif
+#endif
+
+namespace Dsp {
+
+namespace {
+
+// Constant initialised, so there is no question of order at startup.
+// A negative value means none yet.
+std::atomic<int> selectedSet (-1);
+std::atomic<int> forcedSet (-1);
+
+#if DSPFILTERS_X86
+
+void cpuid (unsigned leaf, unsigned subleaf, unsigned regs[4])
+{
+#if defined (_MSC_VER)
+  int r[4];
+  __cpuidex (r, static_cast<int> (leaf), static_cast<int> (subleaf));
+  for (int i = 0; i < 4; ++i)
+    regs[i] = static_cast<unsigned> (r[i]);
+#else
+  regs[0] = regs[1] = regs[2] = regs[3] = 0;
+  if (leaf <= __get_cpuid_max (0, 0))
+    __cpuid_count (leaf, subleaf, regs[0], regs[1], regs[2], regs[3]);
+#endif
+}
+
+// Register state the operating system saves on a context switch
+unsigned long long xgetbv0 ()
+{
+#if defined (_MSC_VER)
+  return _xgetbv (0);
+#else
+  unsigned lo, hi;
+  __asm__ __volatile__ ("xgetbv" : "=a" (lo), "=d" (hi) : "c" (0));
+  return (static_cast<unsigned long long> (hi) << 32) | lo;
+#endif
+}
+
+CpuDispatch::InstructionSet detectX86 ()
+{
+  unsigned regs[4];
+  cpuid (0, 0, regs);
+  const unsigned maxLeaf = regs[0];
+
+  cpuid (1, 0, regs);
+  const bool sse2 = (regs[3] & (1u << 26)) != 0;
+  const bool osxsave = (regs[2] & (1u << 27)) != 0;
+  const bool avx = (regs[2] & (1u << 28)) != 0;
+
+  bool avx2 = false;
+  bool avx512 = false;
+
+  if (osxsave && avx && maxLeaf >= 7)
+  {
+    // The wide registers are only usable if the OS saves them: XMM and
+    // YMM for AVX, plus the mask and upper ZMM state for AVX-512
+    const unsigned long long xcr0 = xgetbv0 ();
+    const bool ymm = (xcr0 & 0x6) == 0x6;
+    const bool zmm = (xcr0 & 0xe6) == 0xe6;
+
+    cpuid (7, 0, regs);
+    avx2 = ymm && (regs[1] & (1u << 5)) != 0;
+    avx512 = avx2 && zmm && (regs[1] & (1u << 16)) != 0;
+  }
+
+#if DSPFILTERS_AVX512
+  if (avx512)
+    return CpuDispatch::avx512;
+#endif
+
+  if (avx2)
+    return CpuDispatch::avx2;
+
+#if DSPFILTERS_SSE2
+  if (sse2)
+    return CpuDispatch::sse2;
+#endif
+
+  return CpuDispatch::generic;
+}
+
+#endif
+
+}
+
+CpuDispatch::InstructionSet CpuDispatch::detect ()
+{
+#if DSPFILTERS_X86
+  // The result can't change while the process runs
+  static const InstructionSet detected = detectX86 ();
+  return detected;
+#elif DSPFILTERS_NEON
+  return neon;
+#else
+  return generic;
+#endif
+}
+
+bool CpuDispatch::isSupported (InstructionSet set)
+{
+  const InstructionSet best = detect ();
+
+  switch (set)
+  {
+  case generic:
+    return true;
+
+  case sse2:
+#if DSPFILTERS_SSE2
+    return best != neon && best >= set;
+#else
+    return false;
+#endif
+
+  // Each x86 set implies the ones below it
+  case avx2:
+  case avx512:
+    return best != neon && best >= set;
+
+  case neon:
+    return best == neon;
+
+  default:
+    return false;
+  };
+}
+
+CpuDispatch::InstructionSet CpuDispatch::select ()
+{
+  const int forced = forcedSet.load (std::memory_order_relaxed);
+  const InstructionSet set = forced >= 0 ? static_cast<InstructionSet> (forced) : detect ();
+
+  selectedSet.store (set, std::memory_order_relaxed);
+  return set;
+}
+
+bool CpuDispatch::force (InstructionSet set)
+{
+  if (set == numInstructionSets)
+  {
+    forcedSet.store (-1, std::memory_order_relaxed);
+    return true;
+  }
+
+  if (!isSupported (set))
+    return false;
+
+  forcedSet.store (set, std::memory_order_relaxed);
+  return true;
+}
+
+CpuDispatch::InstructionSet CpuDispatch::get ()
+{
+  const int set = selectedSet.load (std::memory_order_relaxed);
+  return set >= 0 ? static_cast<InstructionSet> (set) : select ();
+}
+
+const char* CpuDispatch::getName (InstructionSet set)
+{
+  switch (set)
+  {
+  case generic: return "generic";
+  case sse2:    return "SSE2";
+  case avx2:    return "AVX2";
+  case avx512:  return "AVX-512";
+  case neon:    return "NEON";
+  default:      return "";
+  };
+}
+
+}
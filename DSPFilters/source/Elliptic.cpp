@@ -35,6 +35,7 @@ THE SOFTWARE.
 
 #include "DspFilters/Common.h"
 #include "DspFilters/Elliptic.h"
+#include "DspFilters/PrototypeCache.h"
 
 namespace Dsp {
 
@@ -86,6 +87,10 @@ void AnalogLowPass::design (int numPoles,
 
     reset ();
 
+    if (PrototypeCache::find (PrototypeCache::ellipticLowPass,
+                              numPoles, rippleDb, rolloff, *this))
+      return;
+
     // calculate
     //const double ep = rippleDb; // passband ripple
 
@@ -165,6 +170,9 @@ void AnalogLowPass::design (int numPoles,
     }
 
     setNormal (0, (numPoles&1) ? 1. : pow (10., -rippleDb / 20.0));
+
+    PrototypeCache::add (PrototypeCache::ellipticLowPass,
+                         numPoles, rippleDb, rolloff, *this);
   }
 }
 
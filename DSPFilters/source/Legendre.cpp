@@ -35,6 +35,7 @@ THE SOFTWARE.
 
 #include "DspFilters/Common.h"
 #include "DspFilters/Legendre.h"
+#include "DspFilters/PrototypeCache.h"
 #include "DspFilters/RootFinder.h"
 
 #include <sstream>
@@ -243,6 +244,10 @@ void AnalogLowPass::design (int numPoles,
 
     reset ();
 
+    if (PrototypeCache::find (PrototypeCache::legendreLowPass,
+                              numPoles, 0, 0, *this))
+      return;
+
     PolynomialFinderBase& poly (w->poly);
     RootFinderBase& poles (w->roots);
 
@@ -274,6 +279,9 @@ void AnalogLowPass::design (int numPoles,
 
     if (numPoles & 1)
       add (poles.root()[pairs].real(), infinity());
+
+    PrototypeCache::add (PrototypeCache::legendreLowPass,
+                         numPoles, 0, 0, *this);
   }
 }
 
@@ -0,0 +1,222 @@
+/*******************************************************************************
+
+"A Collection of Useful C++ Classes for Digital Signal Processing"
+ By Vincent Falco
+
+Official project location:
+http://code.google.com/p/dspfilterscpp/
+
+See Documentation.cpp for contact information, notes, and bibliography.
+
+--------------------------------------------------------------------------------
+
+License: MIT License (http://www.opensource.org/licenses/mit-license.php)
+Copyright (c) 2009 by Vincent Falco
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+
+*******************************************************************************/
+
+
+#include "DspFilters/Common.h"
+#include "DspFilters/ParallelForm.h"
+
+namespace Dsp {
+
+ParallelForm::ParallelForm ()
+  : m_numSections (0)
+  , m_direct (1)
+{
+}
+
+bool ParallelForm::setCascade (const Cascade& cascade)
+{
+  const int maxPoles = 2 * maxSections;
+
+  complex_t poles [maxPoles];
+  int numPoles = 0;
+  int numZeros = 0;
+
+  // Find the poles of every stage, and count the zeros so that we
+  // know whether the expansion needs anything beyond a direct term
+  for (int i = 0; i < cascade.getNumStages (); ++i)
+  {
+    const Cascade::Stage& s = cascade[i];
+    const double a1 = s.getA1 () / s.getA0 ();
+    const double a2 = s.getA2 () / s.getA0 ();
+
+    numZeros += s.getB2 () != 0 ? 2 : (s.getB1 () != 0 ? 1 : 0);
+
+    if (numPoles + 2 > maxPoles)
+      return false;
+
+    if (a2 != 0)
+    {
+      const double d = a1 * a1 - 4 * a2;
+
+      if (d < 0)
+      {
+        poles [numPoles++] = complex_t (-a1 / 2,  sqrt (-d) / 2);
+        poles [numPoles++] = complex_t (-a1 / 2, -sqrt (-d) / 2);
+      }
+      else
+      {
+        poles [numPoles++] = (-a1 + sqrt (d)) / 2;
+        poles [numPoles++] = (-a1 - sqrt (d)) / 2;
+      }
+    }
+    else if (a1 != 0)
+    {
+      poles [numPoles++] = -a1;
+    }
+  }
+
+  if (numZeros > numPoles)
+    return false;
+
+  // Residue of each pole p, for a term r / (1 - p z^-1)
+  complex_t residues [maxPoles];
+  complex_t residueSum = 0;
+
+  for (int k = 0; k < numPoles; ++k)
+  {
+    const complex_t q = 1. / poles[k];
+
+    complex_t num (1);
+    for (int i = 0; i < cascade.getNumStages (); ++i)
+    {
+      const Cascade::Stage& s = cascade[i];
+      num *= (s.getB0 () + (s.getB1 () + s.getB2 () * q) * q) / s.getA0 ();
+    }
+
+    complex_t den (1);
+    for (int j = 0; j < numPoles; ++j)
+    {
+      if (j == k)
+        continue;
+
+      // Repeated poles would need higher order terms
+      if (std::abs (poles[j] - poles[k]) < 1e-9)
+        return false;
+
+      den *= 1. - poles[j] / poles[k];
+    }
+
+    residues[k] = num / den;
+    residueSum += residues[k];
+  }
+
+  // What is left of the response at z^-1 = 0 is the direct term
+  double direct = 1;
+  for (int i = 0; i < cascade.getNumStages (); ++i)
+    direct *= cascade[i].getB0 () / cascade[i].getA0 ();
+
+  m_numSections = 0;
+  m_direct = direct - residueSum.real ();
+
+  // Conjugate pairs each make one real section, real poles are paired up
+  int pendingReal = -1;
+
+  for (int k = 0; k < numPoles; ++k)
+  {
+    const complex_t p = poles[k];
+    const complex_t r = residues[k];
+
+    if (p.imag () > 0)
+    {
+      addSection (2 * r.real (),
+                  -2 * (r * std::conj (p)).real (),
+                  -2 * p.real (),
+                  std::norm (p));
+    }
+    else if (p.imag () == 0)
+    {
+      if (pendingReal < 0)
+      {
+        pendingReal = k;
+      }
+      else
+      {
+        const double p1 = poles[pendingReal].real ();
+        const double r1 = residues[pendingReal].real ();
+
+        addSection (r1 + r.real (),
+                    -(r1 * p.real () + r.real () * p1),
+                    -(p1 + p.real ()),
+                    p1 * p.real ());
+
+        pendingReal = -1;
+      }
+    }
+  }
+
+  if (pendingReal >= 0)
+    addSection (residues[pendingReal].real (), 0, -poles[pendingReal].real (), 0);
+
+  return true;
+}
+
+complex_t ParallelForm::response (double normalizedFrequency) const
+{
+  const double w = 2 * doublePi * normalizedFrequency;
+  const complex_t czn1 = std::polar (1., -w);
+  const complex_t czn2 = std::polar (1., -2 * w);
+
+  complex_t ch (m_direct);
+
+  for (int i = 0; i < m_numSections; ++i)
+  {
+    const complex_t ct = addmul (complex_t (m_b0[i]), m_b1[i], czn1);
+    const complex_t cb = addmul (addmul (complex_t (1), m_a1[i], czn1), m_a2[i], czn2);
+    ch += ct / cb;
+  }
+
+  return ch;
+}
+
+double ParallelForm::getResponseError (const Cascade& cascade,
+                                       int numFrequencies) const
+{
+  double maxError = 0;
+  double peak = 0;
+
+  for (int i = 0; i < numFrequencies; ++i)
+  {
+    const double f = 0.5 * i / std::max (1, numFrequencies - 1);
+    const complex_t expected = cascade.response (f);
+
+    maxError = std::max (maxError, std::abs (response (f) - expected));
+    peak = std::max (peak, std::abs (expected));
+  }
+
+  return peak > 0 ? maxError / peak : maxError;
+}
+
+void ParallelForm::addSection (double b0, double b1, double a1, double a2)
+{
+  assert (m_numSections < maxSections);
+
+  m_b0[m_numSections] = b0;
+  m_b1[m_numSections] = b1;
+  m_a1[m_numSections] = a1;
+  m_a2[m_numSections] = a2;
+  ++m_numSections;
+}
+
+}
@@ -0,0 +1,222 @@
+/*******************************************************************************
+
+"A Collection of Useful C++ Classes for Digital Signal Processing"
+ By Vincent Falco
+
+Official project location:
+http://code.google.com/p/dspfilterscpp/
+
+See Documentation.cpp for contact information, notes, and bibliography.
+
+--------------------------------------------------------------------------------
+
+License: MIT License (http://www.opensource.org/licenses/mit-license.php)
+Copyright (c) 2009 by Vincent Falco
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+
+*******************************************************************************/
+
+
+#include "DspFilters/Common.h"
+#include "DspFilters/PrototypeCache.h"
+
+#include <atomic>
+
+namespace Dsp {
+
+namespace {
+
+struct Entry
+{
+  Entry (PrototypeCache::Family family_,
+         int numPoles_,
+         double param1_,
+         double param2_,
+         const LayoutBase& proto)
+    : family (family_)
+    , numPoles (numPoles_)
+    , param1 (param1_)
+    , param2 (param2_)
+    , pairs ((proto.getNumPoles () + 1) / 2)
+    , layout (proto.getNumPoles (), pairs.empty () ? 0 : &pairs[0])
+    , next (0)
+  {
+    layout.copyFrom (proto);
+  }
+
+  bool matches (PrototypeCache::Family family_,
+                int numPoles_,
+                double param1_,
+                double param2_) const
+  {
+    return family == family_ &&
+           numPoles == numPoles_ &&
+           param1 == param1_ &&
+           param2 == param2_;
+  }
+
+  const PrototypeCache::Family family;
+  const int numPoles;
+  const double param1;
+  const double param2;
+
+  std::vector <PoleZeroPair> pairs;
+  LayoutBase layout;
+
+  Entry* next;
+};
+
+// A list that only ever grows at its head. An entry is complete before
+// it is published, so readers can follow the list without locking.
+class EntryList
+{
+public:
+  EntryList ()
+    : m_head (0)
+    , m_numEntries (0)
+  {
+  }
+
+  ~EntryList ()
+  {
+    clear ();
+  }
+
+  void clear ()
+  {
+    Entry* entry = m_head.exchange (0);
+    m_numEntries = 0;
+
+    while (entry)
+    {
+      Entry* next = entry->next;
+      delete entry;
+      entry = next;
+    }
+  }
+
+  const Entry* find (PrototypeCache::Family family,
+                     int numPoles,
+                     double param1,
+                     double param2) const
+  {
+    for (const Entry* entry = m_head.load (std::memory_order_acquire);
+         entry; entry = entry->next)
+    {
+      if (entry->matches (family, numPoles, param1, param2))
+        return entry;
+    }
+
+    return 0;
+  }
+
+  void add (Entry* entry)
+  {
+    Entry* head = m_head.load (std::memory_order_acquire);
+
+    do
+    {
+      entry->next = head;
+    }
+    while (!m_head.compare_exchange_weak (head, entry,
+                                          std::memory_order_release,
+                                          std::memory_order_acquire));
+
+    ++m_numEntries;
+  }
+
+  int getNumEntries () const
+  {
+    return m_numEntries.load ();
+  }
+
+private:
+  std::atomic <Entry*> m_head;
+  std::atomic <int> m_numEntries;
+};
+
+// Shaped prototypes get a list of their own, so that they neither use up
+// the room of the ones keyed by order nor lengthen their lookups
+EntryList& getEntries (PrototypeCache::Family family)
+{
+  static EntryList orderEntries;
+  static EntryList shapedEntries;
+
+  return PrototypeCache::isShaped (family) ? shapedEntries : orderEntries;
+}
+
+}
+
+bool PrototypeCache::isShaped (Family family)
+{
+  return family == besselLowShelf || family == ellipticLowPass;
+}
+
+bool PrototypeCache::find (Family family,
+                           int numPoles,
+                           double param1,
+                           double param2,
+                           LayoutBase& proto)
+{
+  const Entry* entry = getEntries (family).find (family, numPoles, param1, param2);
+
+  if (!entry)
+    return false;
+
+  proto.copyFrom (entry->layout);
+  return true;
+}
+
+void PrototypeCache::add (Family family,
+                          int numPoles,
+                          double param1,
+                          double param2,
+                          const LayoutBase& proto)
+{
+  EntryList& entries = getEntries (family);
+  const bool isFull = entries.getNumEntries () >=
+    (isShaped (family) ? maxShapedEntries : maxOrderEntries);
+
+  // Two threads adding the same prototype at once may both get in, which
+  // only costs the memory of one entry
+  if (isFull || entries.find (family, numPoles, param1, param2))
+    return;
+
+  entries.add (new Entry (family, numPoles, param1, param2, proto));
+}
+
+int PrototypeCache::getNumEntries ()
+{
+  return getEntries (besselLowPass).getNumEntries () +
+         getEntries (besselLowShelf).getNumEntries ();
+}
+
+int PrototypeCache::getNumShapedEntries ()
+{
+  return getEntries (besselLowShelf).getNumEntries ();
+}
+
+void PrototypeCache::clear ()
+{
+  getEntries (besselLowPass).clear ();
+  getEntries (besselLowShelf).clear ();
+}
+
+}
@@ -0,0 +1,272 @@
+/*******************************************************************************
+
+"A Collection of Useful C++ Classes for Digital Signal Processing"
+ By Vincent Falco
+
+Official project location:
+http://code.google.com/p/dspfilterscpp/
+
+See Documentation.cpp for contact information, notes, and bibliography.
+
+--------------------------------------------------------------------------------
+
+License: MIT License (http://www.opensource.org/licenses/mit-license.php)
+Copyright (c) 2009 by Vincent Falco
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+
+*******************************************************************************/
+
+
+#include "DspFilters/Common.h"
+#include "DspFilters/StateSpace.h"
+
+namespace Dsp {
+
+BlockStateSpace::BlockStateSpace ()
+  : m_numStages (0)
+  , m_order (0)
+  , m_D (1)
+{
+  for (int i = 0; i < maxStages; ++i)
+    for (int j = 0; j < 5; ++j)
+      m_coeffs[i][j] = 0;
+
+  rebuild ();
+}
+
+bool BlockStateSpace::setCascade (const Cascade& cascade)
+{
+  const int numStages = cascade.getNumStages ();
+
+  if (numStages > maxStages)
+    return false;
+
+  bool changed = numStages != m_numStages;
+
+  for (int i = 0; i < numStages; ++i)
+  {
+    const Cascade::Stage& s = cascade[i];
+    const double coeffs [5] = { s.getB0 () / s.getA0 (),
+                                s.getB1 () / s.getA0 (),
+                                s.getB2 () / s.getA0 (),
+                                s.getA1 () / s.getA0 (),
+                                s.getA2 () / s.getA0 () };
+
+    for (int j = 0; j < 5; ++j)
+    {
+      if (coeffs[j] != m_coeffs[i][j])
+      {
+        m_coeffs[i][j] = coeffs[j];
+        changed = true;
+      }
+    }
+  }
+
+  m_numStages = numStages;
+
+  if (changed)
+    rebuild ();
+
+  return true;
+}
+
+void BlockStateSpace::rebuild ()
+{
+  const int n = 2 * m_numStages;
+  m_order = n;
+
+  // Process runs over more states than the order, which must do nothing
+  for (int j = 0; j < blockSize + maxOrder; ++j)
+    for (int i = 0; i < blockSize + maxOrder; ++i)
+      m_M[j][i] = 0;
+
+  for (int j = 0; j < maxOrder; ++j)
+  {
+    for (int i = 0; i < maxOrder; ++i)
+      m_A[j][i] = 0;
+
+    m_B[j] = 0;
+    m_C[j] = 0;
+  }
+
+  // Realise the cascade stage by stage, each in transposed direct form II
+  // with its two states. The input of each stage is kept as a combination
+  // of the states and the cascade input.
+  double A [maxOrder][maxOrder] = {};
+  double B [maxOrder] = {};
+  double inX [maxOrder] = {};
+  double inU = 1;
+
+  for (int k = 0; k < m_numStages; ++k)
+  {
+    const double b0 = m_coeffs[k][0];
+    const double b1 = m_coeffs[k][1];
+    const double b2 = m_coeffs[k][2];
+    const double a1 = m_coeffs[k][3];
+    const double a2 = m_coeffs[k][4];
+    const int s1 = 2 * k;
+    const int s2 = 2 * k + 1;
+
+    // y = b0*in + s1
+    double yX [maxOrder];
+    for (int j = 0; j < n; ++j)
+      yX[j] = b0 * inX[j];
+    yX[s1] += 1;
+    const double yU = b0 * inU;
+
+    // s1' = b1*in - a1*y + s2,  s2' = b2*in - a2*y
+    for (int j = 0; j < n; ++j)
+    {
+      A[s1][j] = b1 * inX[j] - a1 * yX[j];
+      A[s2][j] = b2 * inX[j] - a2 * yX[j];
+    }
+    A[s1][s2] += 1;
+    B[s1] = b1 * inU - a1 * yU;
+    B[s2] = b2 * inU - a2 * yU;
+
+    for (int j = 0; j < n; ++j)
+      inX[j] = yX[j];
+    inU = yU;
+  }
+
+  // Single step system
+  for (int r = 0; r < n; ++r)
+  {
+    for (int c = 0; c < n; ++c)
+      m_A[c][r] = A[r][c];
+
+    m_B[r] = B[r];
+    m_C[r] = inX[r];
+  }
+  m_D = inU;
+
+  // Observability rows C*A^i, and impulse response terms C*A^(m-1)*B
+  double row [maxOrder];
+  double impulse [blockSize];
+  impulse[0] = m_D;
+
+  for (int j = 0; j < n; ++j)
+    row[j] = m_C[j];
+
+  for (int i = 0; i < blockSize; ++i)
+  {
+    for (int j = 0; j < n; ++j)
+      m_M[blockSize + j][i] = row[j];
+
+    if (i + 1 < blockSize)
+    {
+      double h = 0;
+      for (int j = 0; j < n; ++j)
+        h += row[j] * B[j];
+      impulse[i + 1] = h;
+    }
+
+    double next [maxOrder];
+    for (int c = 0; c < n; ++c)
+    {
+      next[c] = 0;
+      for (int j = 0; j < n; ++j)
+        next[c] += row[j] * A[j][c];
+    }
+
+    for (int j = 0; j < n; ++j)
+      row[j] = next[j];
+  }
+
+  for (int j = 0; j < blockSize; ++j)
+    for (int i = 0; i < blockSize; ++i)
+      m_M[j][i] = i >= j ? impulse[i - j] : 0;
+
+  // Input columns A^(K-1-j)*B, built from the last input backwards
+  double col [maxOrder];
+  for (int r = 0; r < n; ++r)
+    col[r] = B[r];
+
+  for (int j = blockSize; --j >= 0;)
+  {
+    for (int r = 0; r < n; ++r)
+      m_M[j][blockSize + r] = col[r];
+
+    double next [maxOrder];
+    for (int r = 0; r < n; ++r)
+    {
+      next[r] = 0;
+      for (int c = 0; c < n; ++c)
+        next[r] += A[r][c] * col[c];
+    }
+
+    for (int r = 0; r < n; ++r)
+      col[r] = next[r];
+  }
+
+  // A^K
+  double power [maxOrder][maxOrder] = {};
+  for (int r = 0; r < n; ++r)
+    power[r][r] = 1;
+
+  for (int step = 0; step < blockSize; ++step)
+  {
+    double next [maxOrder][maxOrder];
+    for (int r = 0; r < n; ++r)
+    {
+      for (int c = 0; c < n; ++c)
+      {
+        next[r][c] = 0;
+        for (int j = 0; j < n; ++j)
+          next[r][c] += A[r][j] * power[j][c];
+      }
+    }
+
+    for (int r = 0; r < n; ++r)
+      for (int c = 0; c < n; ++c)
+        power[r][c] = next[r][c];
+  }
+
+  for (int r = 0; r < n; ++r)
+    for (int c = 0; c < n; ++c)
+      m_M[blockSize + c][blockSize + r] = power[r][c];
+}
+
+double BlockStateSpace::processSample (double u, double* x) const
+{
+  const int n = m_order;
+
+  double y = m_D * u;
+  double next [maxOrder];
+
+  for (int r = 0; r < n; ++r)
+    next[r] = m_B[r] * u;
+
+  for (int j = 0; j < n; ++j)
+  {
+    const double xj = x[j];
+    y += m_C[j] * xj;
+
+    for (int r = 0; r < n; ++r)
+      next[r] += m_A[j][r] * xj;
+  }
+
+  for (int r = 0; r < n; ++r)
+    x[r] = next[r];
+
+  return y;
+}
+
+}
@@ -0,0 +1,155 @@
+/*******************************************************************************
+
+"A Collection of Useful C++ Classes for Digital Signal Processing"
+ By Vincent Falco
+
+Official project location:
+http://code.google.com/p/dspfilterscpp/
+
+See Documentation.cpp for contact information, notes, and bibliography.
+
+--------------------------------------------------------------------------------
+
+License: MIT License (http://www.opensource.org/licenses/mit-license.php)
+Copyright (c) 2009 by Vincent Falco
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+
+*******************************************************************************/
+
+
+#include "DspFilters/Common.h"
+#include "DspFilters/StateVariable.h"
+
+namespace Dsp {
+
+namespace StateVariable {
+
+namespace {
+
+// tan (pi * x) / (pi * x) is smooth and close to 1 over most of the range,
+// so a linear interpolation of it stays accurate where tan (pi * x) itself
+// is tiny, without needing a huge table
+class PrewarpTable
+{
+public:
+  enum
+  {
+    size = 512
+  };
+
+  PrewarpTable ()
+  {
+    for (int i = 0; i <= size; ++i)
+    {
+      const double x = i * maxNormalizedCutoff / size;
+      m_ratio[i] = (i == 0) ? 1 : tan (doublePi * x) / (doublePi * x);
+    }
+  }
+
+  double lookup (double normalizedCutoff) const
+  {
+    if (normalizedCutoff <= 0)
+      return 0;
+
+    if (normalizedCutoff > maxNormalizedCutoff)
+      normalizedCutoff = maxNormalizedCutoff;
+
+    const double pos = normalizedCutoff * (size / maxNormalizedCutoff);
+    int i = static_cast<int> (pos);
+    if (i > size - 1)
+      i = size - 1;
+
+    const double t = pos - i;
+    const double ratio = m_ratio[i] + t * (m_ratio[i + 1] - m_ratio[i]);
+
+    return doublePi * normalizedCutoff * ratio;
+  }
+
+private:
+  double m_ratio[size + 1];
+};
+
+}
+
+double prewarp (double normalizedCutoff)
+{
+  // Built on first use, so it is ready whichever static initializer asks
+  static const PrewarpTable table;
+
+  return table.lookup (normalizedCutoff);
+}
+
+//------------------------------------------------------------------------------
+
+Coefficients::Coefficients ()
+{
+  // Butterworth damping until set up
+  m_k = sqrt (2.);
+  setGain (0);
+}
+
+void Coefficients::setup (double sampleRate,
+                          double cutoffFrequency,
+                          double q)
+{
+  m_k = 1 / q;
+  setGain (tan (doublePi * cutoffFrequency / sampleRate));
+}
+
+//------------------------------------------------------------------------------
+
+void Base::setEquivalent (double b0, double b1, double b2)
+{
+  // The bilinear transform of the analog prototype, which is what the
+  // trapezoidal integrators realise
+  const double g2 = m_g * m_g;
+  const double kg = m_k * m_g;
+
+  setCoefficients (1 + kg + g2, 2 * (g2 - 1), 1 - kg + g2, b0, b1, b2);
+}
+
+void LowPass::setup (double sampleRate,
+                     double cutoffFrequency,
+                     double q)
+{
+  Coefficients::setup (sampleRate, cutoffFrequency, q);
+  const double g2 = m_g * m_g;
+  setEquivalent (g2, 2 * g2, g2);
+}
+
+void HighPass::setup (double sampleRate,
+                      double cutoffFrequency,
+                      double q)
+{
+  Coefficients::setup (sampleRate, cutoffFrequency, q);
+  setEquivalent (1, -2, 1);
+}
+
+void BandPass::setup (double sampleRate,
+                      double centerFrequency,
+                      double q)
+{
+  Coefficients::setup (sampleRate, centerFrequency, q);
+  setEquivalent (m_g, 0, -m_g);
+}
+
+}
+
+}
@@ -0,0 +1,255 @@
+/*******************************************************************************
+
+"A Collection of Useful C++ Classes for Digital Signal Processing"
+ By Vincent Falco
+
+Official project location:
+http://code.google.com/p/dspfilterscpp/
+
+See Documentation.cpp for contact information, notes, and bibliography.
+
+--------------------------------------------------------------------------------
+
+License: MIT License (http://www.opensource.org/licenses/mit-license.php)
+Copyright (c) 2009 by Vincent Falco
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+
+*******************************************************************************/
+
+
+#include "DspFilters/Common.h"
+#include "DspFilters/CpuDispatch.h"
+#include "DspFilters/Utilities.h"
+#include "DspFilters/UtilityKernels.h"
+
+#if DSPFILTERS_SSE2
+#  include <emmintrin.h>
+#elif DSPFILTERS_NEON
+#  include <arm_neon.h>
+#endif
+
+namespace Dsp {
+
+namespace {
+
+namespace Generic {
+#include "DspFilters/UtilityKernelsImpl.h"
+}
+
+#if DSPFILTERS_SSE2 || DSPFILTERS_NEON
+
+#if DSPFILTERS_SSE2
+#  define DSPFILTERS_KERNELS_SSE2 1
+#else
+#  define DSPFILTERS_KERNELS_NEON 1
+#endif
+
+namespace Baseline {
+#include "DspFilters/UtilityKernelsImpl.h"
+}
+
+#undef DSPFILTERS_KERNELS_SSE2
+#undef DSPFILTERS_KERNELS_NEON
+
+#endif
+
+const UtilityKernels& kernels ()
+{
+  switch (CpuDispatch::get ())
+  {
+#if DSPFILTERS_X86
+#if DSPFILTERS_AVX512
+  case CpuDispatch::avx512: return getAvx512UtilityKernels ();
+#endif
+  case CpuDispatch::avx2:   return getAvx2UtilityKernels ();
+#endif
+#if DSPFILTERS_SSE2
+  case CpuDispatch::sse2:   return Baseline::kernels;
+#elif DSPFILTERS_NEON
+  case CpuDispatch::neon:   return Baseline::kernels;
+#endif
+  default:                  return Generic::kernels;
+  };
+}
+
+}
+
+//------------------------------------------------------------------------------
+
+//
+// Overloads of the reference templates
+//
+
+void add (int samples, float* dest, float const* src, int destSkip, int srcSkip)
+{
+  if (destSkip != 0 || srcSkip != 0)
+    add<float, float> (samples, dest, src, destSkip, srcSkip);
+  else
+    kernels ().addFloat (samples, dest, src);
+}
+
+void add (int samples, double* dest, double const* src, int destSkip, int srcSkip)
+{
+  if (destSkip != 0 || srcSkip != 0)
+    add<double, double> (samples, dest, src, destSkip, srcSkip);
+  else
+    kernels ().addDouble (samples, dest, src);
+}
+
+void add (int samples, double* dest, float const* src, int destSkip, int srcSkip)
+{
+  if (destSkip != 0 || srcSkip != 0)
+    add<double, float> (samples, dest, src, destSkip, srcSkip);
+  else
+    kernels ().addFloatToDouble (samples, dest, src);
+}
+
+void add (int samples, float* dest, double const* src, int destSkip, int srcSkip)
+{
+  if (destSkip != 0 || srcSkip != 0)
+    add<float, double> (samples, dest, src, destSkip, srcSkip);
+  else
+    kernels ().addDoubleToFloat (samples, dest, src);
+}
+
+void copy (int samples, double* dest, float const* src, int destSkip, int srcSkip)
+{
+  if (destSkip != 0 || srcSkip != 0)
+    copy<double, float> (samples, dest, src, destSkip, srcSkip);
+  else
+    kernels ().copyFloatToDouble (samples, dest, src);
+}
+
+void copy (int samples, float* dest, double const* src, int destSkip, int srcSkip)
+{
+  if (destSkip != 0 || srcSkip != 0)
+    copy<float, double> (samples, dest, src, destSkip, srcSkip);
+  else
+    kernels ().copyDoubleToFloat (samples, dest, src);
+}
+
+void deinterleave (int channels, int samples, float* const* dest, float const* src)
+{
+  if (channels == 2)
+    kernels ().deinterleave2Float (samples, dest, src);
+  else if (channels == 8)
+    kernels ().deinterleave8Float (samples, dest, src);
+  else
+    deinterleave<float, float> (channels, samples, dest, src);
+}
+
+void deinterleave (int channels, int samples, double* const* dest, double const* src)
+{
+  if (channels == 2)
+    kernels ().deinterleave2Double (samples, dest, src);
+  else if (channels == 8)
+    kernels ().deinterleave8Double (samples, dest, src);
+  else
+    deinterleave<double, double> (channels, samples, dest, src);
+}
+
+void fade (int samples, float* dest, float start, float end)
+{
+  kernels ().fadeFloat (samples, dest, start, end);
+}
+
+void fade (int samples, double* dest, double start, double end)
+{
+  kernels ().fadeDouble (samples, dest, start, end);
+}
+
+void fade (int samples, float* dest, float const* src, float start, float end)
+{
+  kernels ().crossFadeFloat (samples, dest, src, start, end);
+}
+
+void fade (int samples, double* dest, double const* src, double start, double end)
+{
+  kernels ().crossFadeDouble (samples, dest, src, start, end);
+}
+
+void interleave (int channels, size_t samples, float* dest, float const* const* src)
+{
+  if (channels == 2)
+    kernels ().interleave2Float (static_cast<int> (samples), dest, src);
+  else if (channels == 8)
+    kernels ().interleave8Float (static_cast<int> (samples), dest, src);
+  else
+    interleave<float, float> (channels, samples, dest, src);
+}
+
+void interleave (int channels, size_t samples, double* dest, double const* const* src)
+{
+  if (channels == 2)
+    kernels ().interleave2Double (static_cast<int> (samples), dest, src);
+  else if (channels == 8)
+    kernels ().interleave8Double (static_cast<int> (samples), dest, src);
+  else
+    interleave<double, double> (channels, samples, dest, src);
+}
+
+void multiply (int samples, float* dest, float factor, int destSkip)
+{
+  if (destSkip != 0)
+    multiply<float, float> (samples, dest, factor, destSkip);
+  else
+    kernels ().multiplyFloat (samples, dest, factor);
+}
+
+void multiply (int samples, double* dest, double factor, int destSkip)
+{
+  if (destSkip != 0)
+    multiply<double, double> (samples, dest, factor, destSkip);
+  else
+    kernels ().multiplyDouble (samples, dest, factor);
+}
+
+void reverse (int samples, float* dest, float const* src, int destSkip, int srcSkip)
+{
+  if (destSkip != 0 || srcSkip != 0)
+    reverse<float, float> (samples, dest, src, destSkip, srcSkip);
+  else
+    kernels ().reverseFloat (samples, dest, src);
+}
+
+void reverse (int samples, double* dest, double const* src, int destSkip, int srcSkip)
+{
+  if (destSkip != 0 || srcSkip != 0)
+    reverse<double, double> (samples, dest, src, destSkip, srcSkip);
+  else
+    kernels ().reverseDouble (samples, dest, src);
+}
+
+void saturate (int samples, float* dest, float amount)
+{
+  kernels ().saturateFloat (samples, dest, amount);
+}
+
+void to_mono (int samples, float* dest, float const* left, float const* right)
+{
+  kernels ().toMonoFloat (samples, dest, left, right);
+}
+
+void to_mono (int samples, double* dest, double const* left, double const* right)
+{
+  kernels ().toMonoDouble (samples, dest, left, right);
+}
+
+}
@@ -0,0 +1,90 @@
+/*******************************************************************************
+
+"A Collection of Useful C++ Classes for Digital Signal Processing"
+ By Vincent Falco
+
+Official project location:
+http://code.google.com/p/dspfilterscpp/
+
+See Documentation.cpp for contact information, notes, and bibliography.
+
+--------------------------------------------------------------------------------
+
+License: MIT License (http://www.opensource.org/licenses/mit-license.php)
+Copyright (c) 2009 by Vincent Falco
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+
+*******************************************************************************/
+
+
+#include "DspFilters/Common.h"
+#include "DspFilters/CpuDispatch.h"
+#include "DspFilters/Utilities.h"
+#include "DspFilters/UtilityKernels.h"
+
+//
+// The Utilities kernels compiled for AVX-512, which is only ever called once
+// CpuDispatch has found it supported. Everything in the region below is
+// compiled for the set, the table getter after it isn't. Contracting a
+// multiply and add into one FMA would round differently from the other
+// sets, so neither compiler is allowed to.
+//
+
+#if DSPFILTERS_X86 && DSPFILTERS_AVX512
+
+#include <immintrin.h>
+
+#if defined (__clang__)
+#  pragma clang attribute push (__attribute__ ((target ("avx512f"))), apply_to = function)
+#  pragma clang fp contract (off)
+#elif defined (__GNUC__)
+#  pragma GCC push_options
+#  pragma GCC target ("avx512f")
+#  pragma GCC optimize ("fp-contract=off")
+#endif
+
+namespace Dsp {
+
+namespace {
+
+#define DSPFILTERS_KERNELS_AVX512 1
+#include "DspFilters/UtilityKernelsImpl.h"
+#undef DSPFILTERS_KERNELS_AVX512
+
+}
+
+}
+
+#if defined (__clang__)
+#  pragma clang attribute pop
+#elif defined (__GNUC__)
+#  pragma GCC pop_options
+#endif
+
+namespace Dsp {
+
+const UtilityKernels& getAvx512UtilityKernels ()
+{
+  return kernels;
+}
+
+}
+
+#endif
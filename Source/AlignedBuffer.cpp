@@ -0,0 +1,60 @@
+/*
+------------------------------------------------------------------------------
+
+Aligned buffer
+================
+Preallocated scratch memory for the Roth-AIR processing chain, with every
+channel starting on a cache line boundary.
+
+By Daniel Rothmann
+
+Provided under GNU General Public license:
+http://www.gnu.org/licenses/
+
+------------------------------------------------------------------------------
+*/
+
+#include "AlignedBuffer.h"
+
+//====================================================
+
+AlignedBuffer::AlignedBuffer()
+{
+}
+
+void AlignedBuffer::setSize(int newNumChannels, int newNumSamples)
+{
+	jassert(newNumChannels > 0 && newNumSamples > 0);
+
+	numChannels = newNumChannels;
+	numSamples = newNumSamples;
+
+	// Round each channel up to whole cache lines
+	const int floatsPerLine = alignment / (int) sizeof(float);
+	const int stride = (numSamples + floatsPerLine - 1) / floatsPerLine * floatsPerLine;
+
+	// Allocate one extra line to have room for aligning the start
+	storage.calloc((size_t) numChannels * stride * sizeof(float) + alignment);
+	channels.malloc(numChannels);
+
+	const pointer_sized_int address = (pointer_sized_int) storage.get();
+	float* const start = (float*) ((address + alignment - 1) & ~(pointer_sized_int) (alignment - 1));
+
+	for (int channel = 0; channel < numChannels; ++channel)
+		channels[channel] = start + channel * stride;
+}
+
+float** AlignedBuffer::getArrayOfWritePointers()
+{
+	return channels.get();
+}
+
+int AlignedBuffer::getNumChannels() const
+{
+	return numChannels;
+}
+
+int AlignedBuffer::getNumSamples() const
+{
+	return numSamples;
+}
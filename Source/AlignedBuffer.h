@@ -0,0 +1,50 @@
+/*
+------------------------------------------------------------------------------
+
+Aligned buffer
+================
+Preallocated scratch memory for the Roth-AIR processing chain, with every
+channel starting on a cache line boundary.
+
+The channels are padded to a whole number of cache lines, so vector loads
+never straddle two lines and no two channels share one. An AudioSampleBuffer
+that refers to the channels can be pointed at them with setDataToReferTo().
+
+By Daniel Rothmann
+
+Provided under GNU General Public license:
+http://www.gnu.org/licenses/
+
+------------------------------------------------------------------------------
+*/
+
+#ifndef ALIGNEDBUFFER_H_INCLUDED
+#define ALIGNEDBUFFER_H_INCLUDED
+
+#include "../JuceLibraryCode/JuceHeader.h"
+
+class AlignedBuffer
+{
+public:
+	// Alignment of each channel, in bytes
+	static const int alignment = 64;
+
+	AlignedBuffer();
+
+	// Allocate cleared memory for a number of channels (not realtime safe)
+	void setSize(int newNumChannels, int newNumSamples);
+
+	float** getArrayOfWritePointers();
+	int getNumChannels() const;
+	int getNumSamples() const;
+
+private:
+	HeapBlock<char> storage;
+	HeapBlock<float*> channels;
+	int numChannels = 0;
+	int numSamples = 0;
+
+	JUCE_DECLARE_NON_COPYABLE(AlignedBuffer)
+};
+
+#endif  // ALIGNEDBUFFER_H_INCLUDED
@@ -19,33 +19,34 @@ Compressor::Compressor(int channels, int sample_rate) :
 	fDeNormal(FLT_MIN),
 	dDeNormal(DBL_MIN),
 	dBufferLength(0.1),
+	dReleasedTolerance(1e-5),
+	bReleasedFastPath(true),
 	nChannels(channels),
 	nSampleRate(sample_rate)
 {
-	jassert((channels == 1) || (channels == 2));
+	jassert(channels > 0);
 
-	bufInputSamples.clear();
-	bufSideChainSamples.clear();
-	bufOutputSamples.clear();
-
-	bufInputSamples.setSize(nChannels, 1);
-	bufSideChainSamples.setSize(nChannels, 1);
-	bufOutputSamples.setSize(nChannels, 1);
-    
     dCrestFactor = 20.0;
     dReleaseCoefLinear = 26 * dBufferLength / 3.0;
     
     setMakeupGain(0.0);
+    tempGainReduction = 0.0;
     
     // Clear the sidechain array in case of junk
     p_arrSideChain.clear();
 
 	// Add sidechain objects and add an entry for each channel into the sample buffers
-	for (int nChannel = 0; nChannel < 2; ++nChannel)
+	for (int nChannel = 0; nChannel < nChannels; ++nChannel)
 	{
         // Make a new sidechain element for each channel
 		p_arrSideChain.add(new SideChain(nSampleRate));
+		arrChannelActive.add(true);
 	}
+
+	for (int nPair = 0; nPair < (nChannels + 1) / 2; ++nPair)
+		p_arrEnvelopeFollower.add(new EnvelopeFollower());
+
+	updateEnvelopeFollowers();
 }
 
 Compressor::~Compressor() {
@@ -94,6 +95,20 @@ void Compressor::setThreshold(double dThresholdNew)
 	}
 }
 
+void Compressor::setThreshold(int nChannel, double dThresholdNew)
+/* Set new threshold for a single channel.
+
+	nChannel (int): audio channel
+	dThresholdNew (double): new threshold in dB
+
+	return value: none*/
+{
+	jassert(nChannel >= 0);
+	jassert(nChannel < nChannels);
+
+	p_arrSideChain[nChannel]->setThreshold(dThresholdNew);
+}
+
 double Compressor::getRatio()
 /* Get current comp ratio.
 
@@ -117,6 +132,80 @@ void Compressor::setRatio(double dRatioNew)
 	}
 }
 
+void Compressor::setRatio(int nChannel, double dRatioNew)
+/* Set new ratio for a single channel.
+
+	nChannel (int): audio channel
+	dRatioNew (double): new ratio
+
+	return value: none*/
+{
+	jassert(nChannel >= 0);
+	jassert(nChannel < nChannels);
+
+	p_arrSideChain[nChannel]->setRatio(dRatioNew);
+}
+
+int Compressor::getDetectorType()
+/* Get current detector type.
+
+	return value (int): returns current SideChain detector type*/
+{
+	return p_arrSideChain[0]->getDetectorType();
+}
+
+void Compressor::setDetectorType(int nDetectorTypeNew)
+/* Set new detector type.
+
+	nDetectorTypeNew (int): one of SideChain::DetectorType
+
+	return value: none*/
+{
+	for (int nChannel = 0; nChannel < nChannels; ++nChannel)
+	{
+		p_arrSideChain[nChannel]->setDetectorType(nDetectorTypeNew);
+	}
+
+	updateEnvelopeFollowers();
+}
+
+bool Compressor::isChannelActive(int nChannel)
+/* Get whether a channel is processed.
+
+	nChannel (int): queried audio channel
+
+	return value (bool): false if the channel is bypassed*/
+{
+	return arrChannelActive[nChannel];
+}
+
+void Compressor::setChannelActive(int nChannel, bool shouldBeActive)
+/* Bypass or resume a channel. A bypassed channel is left untouched by
+	processBlock, and its sidechain starts over from silence when it resumes.
+
+	nChannel (int): audio channel
+	shouldBeActive (bool): false to bypass the channel
+
+	return value: none*/
+{
+	jassert(nChannel >= 0);
+	jassert(nChannel < nChannels);
+
+	if (shouldBeActive != arrChannelActive[nChannel])
+	{
+		arrChannelActive.set(nChannel, shouldBeActive);
+
+		if (! shouldBeActive)
+		{
+			p_arrSideChain[nChannel]->reset();
+			p_arrEnvelopeFollower[nChannel / 2]->m_env[nChannel % 2] = 0.0;
+
+			if (nChannel < 2)
+				tempGainReduction = 0.0;
+		}
+	}
+}
+
 int Compressor::getAttackRate()
 /* Get current attack rate.
 
@@ -136,6 +225,8 @@ void Compressor::setAttackRate(int nAttackRateNew)
 	{
 		p_arrSideChain[nChannel]->setAttackRate(nAttackRateNew);
 	}
+
+	updateEnvelopeFollowers();
 }
 
 int Compressor::getReleaseRate()
@@ -157,6 +248,8 @@ return value: none*/
 	{
 		p_arrSideChain[nChannel]->setReleaseRate(nReleaseRateNew);
 	}
+
+	updateEnvelopeFollowers();
 }
 
 double Compressor::getMakeupGain()
@@ -219,14 +312,52 @@ void Compressor::setSampleRate(double newSampleRate)
 		}
 
 		nSampleRate = (int)newSampleRate;
+		updateEnvelopeFollowers();
 	}
 }
 
 void Compressor::resetSideChain() {
-    for (int nChannel = 0; nChannel < 2; ++nChannel)
+    for (int nChannel = 0; nChannel < nChannels; ++nChannel)
     {
         p_arrSideChain[nChannel]->reset();
     }
+
+	for (int nPair = 0; nPair < p_arrEnvelopeFollower.size(); ++nPair)
+		p_arrEnvelopeFollower[nPair]->Reset();
+
+	tempGainReduction = 0.0;
+}
+
+void Compressor::updateEnvelopeFollowers()
+/* Match the envelope followers to the sidechain settings. The followers are timed
+	to 1% of a step and the sidechain envelopes to 10%, so their times are doubled.
+
+	return value: none*/
+{
+	const EnvelopeFollower::Mode mode = (getDetectorType() == SideChain::detectorEnvelopeRms)
+		? EnvelopeFollower::modeRms : EnvelopeFollower::modePeak;
+
+	for (int nPair = 0; nPair < p_arrEnvelopeFollower.size(); ++nPair)
+	{
+		EnvelopeFollower* pFollower = p_arrEnvelopeFollower[nPair];
+		pFollower->SetMode(mode);
+		pFollower->Setup(nSampleRate, 2.0 * getAttackRate(), 2.0 * getReleaseRate());
+	}
+}
+
+double Compressor::getFullReleaseSeconds(double dGainReductionDb)
+/* Get the time the sidechain takes to release fully, down to the tolerance used by
+	the below-threshold fast path, once the input has dropped away.
+
+	dGainReductionDb (double): gain reduction to release from in dB
+
+	return value (double): release time in seconds*/
+{
+	// Every envelope falls by a factor of ten per rate (the RMS filter works on squared levels)
+	double dDecades = log10(jmax(dGainReductionDb, dReleasedTolerance) / dReleasedTolerance);
+	double dRatesMs = getReleaseRate() + getAttackRate() + 2.0 * getDetectorRmsFilter();
+
+	return dDecades * dRatesMs / 1000.0;
 }
 
 double Compressor::getTempGainReduction()
@@ -234,62 +365,191 @@ double Compressor::getTempGainReduction()
 	return tempGainReduction;
 }
 
+bool Compressor::isReleasedFastPathEnabled()
+/* Get whether released chunks below threshold skip the per-sample loop.
+
+	return value (bool): true if the fast path is enabled*/
+{
+	return bReleasedFastPath;
+}
+
+void Compressor::setReleasedFastPathEnabled(bool shouldBeEnabled)
+/* Enable or disable the fast path for released chunks below threshold. With it
+	disabled every sample goes through the sidechain, which is slower but is what
+	the fast path must match.
+
+	shouldBeEnabled (bool): true to enable the fast path
+
+	return value: none*/
+{
+	bReleasedFastPath = shouldBeEnabled;
+}
+
+double Compressor::getReleasedTolerance()
+/* Get the remaining gain reduction below which a sidechain counts as released.
+	The fast path may differ from the per-sample path by up to this much.
+
+	return value (double): tolerance in dB*/
+{
+	return dReleasedTolerance;
+}
+
 void Compressor::processBlock(AudioBuffer<float> &buffer)
 {
+	processChannels(buffer, 0, jmin(nChannels, buffer.getNumChannels()));
+}
+
+void Compressor::processChannels(AudioBuffer<float> &buffer, int startChannel, int numChannels)
+{
+	jassert(startChannel >= 0 && startChannel + numChannels <= jmin(nChannels, buffer.getNumChannels()));
+
 	int nNumSamples = buffer.getNumSamples();
+	int nEndChannel = startChannel + numChannels;
 
-	// Loop through samples
-	for (int nSample = 0; nSample < nNumSamples; ++nSample)
+	// Peak levels of the current chunk in true peak mode
+	const int nChunkSize = 64;
+	float arrPeaks[nChunkSize];
+
+	// Channels are not linked, so process them one at a time
+	for (int nChannel = startChannel; nChannel < nEndChannel; ++nChannel)
 	{
-		// Get input samples, de-normalize and store in buffer
-		for (int nChannel = 0; nChannel < nChannels; ++nChannel)
+		// Leave bypassed channels untouched
+		if (! arrChannelActive.getUnchecked(nChannel))
+			continue;
+
+		SideChain* pSideChain = p_arrSideChain.getUnchecked(nChannel);
+
+		// The envelope detector follows both channels of a pair at once where it can
+		if (pSideChain->isEnvelopeDetector())
 		{
-			// Get current input sample (both as float and as double)
-			float fInputSample = buffer.getSample(nChannel, nSample);
-			double dInputSample = (double) fInputSample;
+			const bool bPair = (nChannel % 2 == 0) && nChannel + 1 < nEndChannel
+				&& arrChannelActive.getUnchecked(nChannel + 1);
 
-			// Remove denormal numbers input samples
-			fInputSample += fDeNormal;
-			dInputSample += dDeNormal;
-			fInputSample -= fDeNormal;
-			dInputSample -= dDeNormal;
+			processEnvelopeChannels(buffer, nChannel, bPair ? 2 : 1);
 
-			// jassert(arrInputSamples.size() == 2 && arrSidechainSamples.size() == 2 && arrOutputSamples.size() == 2);
+			if (bPair)
+				++nChannel;
 
-			// Store de-normalized input sample
-			// arrInputSamples.set(nChannel, dInputSample);
-			bufInputSamples.setSample(nChannel, 0, dInputSample);
+			continue;
+		}
 
-			// Process each channel instead of stereo linking (for channel compability)
-			// arrSidechainSamples.set(nChannel, arrInputSamples[nChannel]);
-			bufSideChainSamples.setSample(nChannel, 0, bufInputSamples.getSample(nChannel, 0));
+		float* pfSamples = buffer.getWritePointer(nChannel);
+		const bool bTruePeak = (pSideChain->getDetectorType() == SideChain::detectorTruePeak);
 
-			// Calculate level of sidechain sample
-			double dSideChainInputLevel = SideChain::lvltodb(fabs(bufSideChainSamples.getSample(nChannel, 0)));
+		for (int nChunkStart = 0; nChunkStart < nNumSamples; nChunkStart += nChunkSize)
+		{
+			const int nChunk = jmin(nChunkSize, nNumSamples - nChunkStart);
 
-			// Apply crest factor
-			dSideChainInputLevel += dCrestFactor;
+			// Interpolate the whole chunk before its samples are overwritten
+			if (bTruePeak)
+				pSideChain->detectTruePeaks(pfSamples + nChunkStart, arrPeaks, nChunk);
 
-			// Send current input sample to gain reduction
-			p_arrSideChain[nChannel]->processSample(dSideChainInputLevel);
+			processChunk(nChannel, pfSamples + nChunkStart, bTruePeak ? arrPeaks : nullptr, nChunk);
+		}
+	}
+}
 
-			// Store gain reduction (might only be for metering)
-			// arrGainReduction.set(nChannel, p_arrSideChain[nChannel]->getGainReduction());
+void Compressor::processEnvelopeChannels(AudioBuffer<float> &buffer, int startChannel, int numChannels)
+{
+	jassert(numChannels == 1 || (numChannels == 2 && startChannel % 2 == 0));
 
-			// Apply gain reduction to current input sample
-			double dGainReduction = p_arrSideChain[nChannel]->getGainReduction();
-			tempGainReduction = dGainReduction;
+	int nNumSamples = buffer.getNumSamples();
+	EnvelopeFollower* pFollower = p_arrEnvelopeFollower.getUnchecked(startChannel / 2);
 
-			// arrOutputSamples.set(nChannel, arrInputSamples[nChannel] / SideChain::dbtolvl(dGainReduction));
-			bufOutputSamples.setSample(nChannel, 0, bufInputSamples.getSample(nChannel, 0) / SideChain::dbtolvl(dGainReduction));
+	// Envelope of the current chunk, per channel
+	const int nChunkSize = 64;
+	float arrLevels[2][nChunkSize];
+	float* pfLevels[2] = { arrLevels[0], arrLevels[1] };
 
-			// arrOutputSamples.set(nChannel, arrOutputSamples[nChannel] * dMakeupGain);
-			bufOutputSamples.setSample(nChannel, 0, bufOutputSamples.getSample(nChannel, 0) * dMakeupGain);
+	for (int nChunkStart = 0; nChunkStart < nNumSamples; nChunkStart += nChunkSize)
+	{
+		const int nChunk = jmin(nChunkSize, nNumSamples - nChunkStart);
 
-			// Set sample to output buffer
-			// float fOutput = arrOutputSamples[nChannel];
-			float fOutput = bufOutputSamples.getSample(nChannel, 0);
-			buffer.setSample(nChannel, nSample, fOutput);
+		// Follow the whole chunk before its samples are overwritten
+		if (numChannels == 2)
+		{
+			const float* pfInputs[2] = { buffer.getReadPointer(startChannel, nChunkStart),
+										 buffer.getReadPointer(startChannel + 1, nChunkStart) };
+			pFollower->Process(nChunk, pfInputs, pfLevels);
+		}
+		else
+		{
+			pFollower->Process(nChunk, buffer.getReadPointer(startChannel, nChunkStart), pfLevels[0], startChannel % 2);
 		}
+
+		for (int i = 0; i < numChannels; ++i)
+			processChunk(startChannel + i, buffer.getWritePointer(startChannel + i, nChunkStart), pfLevels[i], nChunk);
+	}
+}
+
+void Compressor::processChunk(int nChannel, float* pfSamples, const float* pfLevels, int nChunk)
+{
+	SideChain* pSideChain = p_arrSideChain.getUnchecked(nChannel);
+
+	// Find the chunk peak
+	const float* pfPeakLevels = (pfLevels != nullptr) ? pfLevels : pfSamples;
+	float fChunkPeak = 0.0f;
+
+	for (int i = 0; i < nChunk; ++i)
+		fChunkPeak = jmax(fChunkPeak, fabsf(pfPeakLevels[i]));
+
+	// Fast path: if the whole chunk is below threshold and the envelopes have released,
+	// the gain is constant and the envelopes can be stepped in one go
+	if (bReleasedFastPath
+		&& SideChain::lvltodb(fChunkPeak) + dCrestFactor <= pSideChain->getThreshold()
+		&& pSideChain->isReleased(dReleasedTolerance))
+	{
+		const double dGainReduction = pSideChain->getGainReduction();
+		const float fGain = (float) (dMakeupGain / SideChain::dbtolvl(dGainReduction));
+
+		Dsp::multiply(nChunk, pfSamples, fGain);
+		pSideChain->skipReleasedSamples(nChunk);
+
+		// The meter follows the right channel of the first pair (only one thread may write it)
+		if (nChannel == 1)
+			tempGainReduction = pSideChain->getGainReduction();
+
+		return;
+	}
+
+	// Loop through samples
+	for (int i = 0; i < nChunk; ++i)
+	{
+		// Get current input sample (both as float and as double)
+		float fInputSample = pfSamples[i];
+		double dInputSample = (double) fInputSample;
+
+		// Remove denormal numbers input samples
+		fInputSample += fDeNormal;
+		dInputSample += dDeNormal;
+		fInputSample -= fDeNormal;
+		dInputSample -= dDeNormal;
+
+		// Store de-normalized input sample (kept in single precision, like the sample buffers)
+		// Process each channel instead of stereo linking (for channel compability)
+		float fSideChainSample = (float) dInputSample;
+
+		// Calculate level of sidechain sample
+		double dSideChainInputLevel = SideChain::lvltodb((pfLevels != nullptr) ? pfLevels[i] : fabs(fSideChainSample));
+
+		// Apply crest factor
+		dSideChainInputLevel += dCrestFactor;
+
+		// Send current input sample to gain reduction
+		pSideChain->processSample(dSideChainInputLevel);
+
+		// Apply gain reduction to current input sample
+		double dGainReduction = pSideChain->getGainReduction();
+
+		// The meter follows the right channel of the first pair (only one thread may write it)
+		if (nChannel == 1)
+			tempGainReduction = dGainReduction;
+
+		// Apply gain reduction and makeup gain
+		float fOutput = (float) (fSideChainSample / SideChain::dbtolvl(dGainReduction));
+		fOutput = (float) (fOutput * dMakeupGain);
+
+		// Set sample to output buffer
+		pfSamples[i] = fOutput;
 	}
 }
@@ -15,6 +15,7 @@
 class SideChain;
 
 #include "../JuceLibraryCode/JuceHeader.h"
+#include "DspFilters/Utilities.h"
 #include "SideChain.h"
 
 //=============================================================
@@ -33,9 +34,17 @@ public:
 
 	double getThreshold();
 	void setThreshold(double dThresholdNew);
+	void setThreshold(int nChannel, double dThresholdNew);
 
 	double getRatio();
 	void setRatio(double dRatioNew);
+	void setRatio(int nChannel, double dRatioNew);
+
+	int getDetectorType();
+	void setDetectorType(int nDetectorTypeNew);
+
+	bool isChannelActive(int nChannel);
+	void setChannelActive(int nChannel, bool shouldBeActive);
 
 	int getAttackRate();
 	void setAttackRate(int nAttackRateNew);
@@ -54,31 +63,52 @@ public:
     
     void resetSideChain();
 
+	double getFullReleaseSeconds(double dGainReductionDb);
+
 	double getTempGainReduction();
 
+	// The below-threshold fast path is on by default; tests turn it off to compare it
+	// with the per-sample path
+	bool isReleasedFastPathEnabled();
+	void setReleasedFastPathEnabled(bool shouldBeEnabled);
+	double getReleasedTolerance();
+
 	// Declare function for processing audio
 	void processBlock(AudioBuffer<float> &buffer);
 
+	// Process a range of channels only; disjoint ranges may run on different threads
+	void processChannels(AudioBuffer<float> &buffer, int startChannel, int numChannels);
+
 private:
 	// Declare de-normalization variables
     const float fDeNormal;
 	const double dDeNormal;
 	const double dBufferLength;
 
+	// Remaining gain reduction (dB) below which a sidechain counts as released
+	const double dReleasedTolerance;
+	bool bReleasedFastPath;
+
 	// Variables for keeping track of channels and sample rate
 	int nChannels;
 	int nSampleRate;
 
 	// Arrays for holding sample data
 	OwnedArray<SideChain> p_arrSideChain;
+	Array<bool> arrChannelActive;
+
+	// Envelope detectors, following each pair of channels together
+	typedef Dsp::EnvelopeFollower<2, float> EnvelopeFollower;
+	OwnedArray<EnvelopeFollower> p_arrEnvelopeFollower;
+
+	void updateEnvelopeFollowers();
 
-	// Array<double> arrInputSamples;
-	// Array<double> arrSidechainSamples;
-	// Array<double> arrOutputSamples;
+	// Compress a chunk of one channel, given the level of each sample (or nullptr to use
+	// the sample peaks)
+	void processChunk(int nChannel, float* pfSamples, const float* pfLevels, int nChunk);
 
-	AudioSampleBuffer bufInputSamples;
-	AudioSampleBuffer bufSideChainSamples;
-	AudioSampleBuffer bufOutputSamples;
+	// Compress one channel or a pair of channels with the envelope detector
+	void processEnvelopeChannels(AudioBuffer<float> &buffer, int startChannel, int numChannels);
 
 	Array<double> arrGainReduction;
 	Array<double> arrGainReductionPeak;
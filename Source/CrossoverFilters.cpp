@@ -0,0 +1,112 @@
+/*
+------------------------------------------------------------------------------
+
+Crossover filters
+================
+The filter families and orders the Roth-AIR crossover can be built from.
+
+By Daniel Rothmann
+
+Provided under GNU General Public license:
+http://www.gnu.org/licenses/
+
+------------------------------------------------------------------------------
+*/
+
+#include "CrossoverFilters.h"
+
+//====================================================
+
+namespace
+{
+	// The designs alone, without state, as the filtering is done by a Dsp::FilterBank
+	template <class LowPassDesign, class HighPassDesign>
+	class DesignPair : public CrossoverFilters::Pair
+	{
+	public:
+		void setParams(const Dsp::Params& params) override
+		{
+			lowPass.setParams(params);
+			highPass.setParams(params);
+		}
+
+		const Dsp::Filter& getLowPass() const override
+		{
+			return lowPass;
+		}
+
+		const Dsp::Cascade& getLowPassCascade() const override
+		{
+			return lowPass.getDesign();
+		}
+
+		const Dsp::Cascade& getHighPassCascade() const override
+		{
+			return highPass.getDesign();
+		}
+
+	private:
+		Dsp::FilterDesign <LowPassDesign> lowPass;
+		Dsp::FilterDesign <HighPassDesign> highPass;
+	};
+
+	template <class LowPassDesign, class HighPassDesign>
+	CrossoverFilters::Pair* createPair()
+	{
+		return new DesignPair <LowPassDesign, HighPassDesign>();
+	}
+
+	struct FamilyDesigns
+	{
+		const char* name;
+		CrossoverFilters::Pair* (*createPair)();
+	};
+
+	// Indexed by CrossoverFilters::Family
+	const FamilyDesigns familyDesigns[CrossoverFilters::numFamilies] =
+	{
+		{ "Bessel",
+		  createPair <Dsp::Bessel::Design::LowPass<CrossoverFilters::maxOrder>,
+					  Dsp::Bessel::Design::HighPass<CrossoverFilters::maxOrder>> },
+		{ "Butterworth",
+		  createPair <Dsp::Butterworth::Design::LowPass<CrossoverFilters::maxOrder>,
+					  Dsp::Butterworth::Design::HighPass<CrossoverFilters::maxOrder>> },
+		{ "Chebyshev I",
+		  createPair <Dsp::ChebyshevI::Design::LowPass<CrossoverFilters::maxOrder>,
+					  Dsp::ChebyshevI::Design::HighPass<CrossoverFilters::maxOrder>> },
+		{ "Chebyshev II",
+		  createPair <Dsp::ChebyshevII::Design::LowPass<CrossoverFilters::maxOrder>,
+					  Dsp::ChebyshevII::Design::HighPass<CrossoverFilters::maxOrder>> },
+		{ "Elliptic",
+		  createPair <Dsp::Elliptic::Design::LowPass<CrossoverFilters::maxOrder>,
+					  Dsp::Elliptic::Design::HighPass<CrossoverFilters::maxOrder>> },
+		{ "Legendre",
+		  createPair <Dsp::Legendre::Design::LowPass<CrossoverFilters::maxOrder>,
+					  Dsp::Legendre::Design::HighPass<CrossoverFilters::maxOrder>> }
+	};
+}
+
+const char* CrossoverFilters::getFamilyName(int family)
+{
+	jassert(family >= 0 && family < numFamilies);
+	return familyDesigns[family].name;
+}
+
+CrossoverFilters::Pair* CrossoverFilters::createPair(int family)
+{
+	jassert(family >= 0 && family < numFamilies);
+	return familyDesigns[family].createPair();
+}
+
+Dsp::Params CrossoverFilters::getParams(const Dsp::Filter& filter, double sampleRate, int order, double freq)
+{
+	jassert(order >= minOrder && order <= maxOrder);
+
+	// Ripple, stopband and transition width keep the library's defaults
+	Dsp::Params params = filter.getDefaultParams();
+	params[0] = sampleRate;
+	params[1] = order;
+	params[2] = freq;
+
+	return params;
+}
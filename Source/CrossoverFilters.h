@@ -0,0 +1,75 @@
+/*
+------------------------------------------------------------------------------
+
+Crossover filters
+================
+The filter families and orders the Roth-AIR crossover can be built from.
+
+Each family maps to its DSPFilters low and high pass designs through a table
+of factory functions that is filled in at compile time, so choosing a family
+costs one lookup when the designs are created. The designs only hold the
+coefficients, which a CrossoverSplit runs through a Dsp::FilterBank.
+
+The benchmark times a stereo split of every family and order at the
+crossover frequency, so the cheapest slope that meets a spec can be picked
+from measured numbers.
+
+By Daniel Rothmann
+
+Provided under GNU General Public license:
+http://www.gnu.org/licenses/
+
+------------------------------------------------------------------------------
+*/
+
+#ifndef CROSSOVERFILTERS_H_INCLUDED
+#define CROSSOVERFILTERS_H_INCLUDED
+
+#include "../JuceLibraryCode/JuceHeader.h"
+#include "DspFilters/Dsp.h"
+
+namespace CrossoverFilters
+{
+	enum Family
+	{
+		familyBessel = 0,
+		familyButterworth,
+		familyChebyshevI,
+		familyChebyshevII,
+		familyElliptic,
+		familyLegendre,
+		numFamilies
+	};
+
+	// Orders every family can be designed at
+	const int minOrder = 1;
+	const int maxOrder = 4;
+
+	// Stages of the longest cascade of any family and order
+	const int maxStages = (maxOrder + 1) / 2;
+
+	const char* getFamilyName(int family);
+
+	// Low and high pass designs of a family, set up with the same parameters
+	class Pair
+	{
+	public:
+		virtual ~Pair() {}
+
+		virtual void setParams(const Dsp::Params& params) = 0;
+
+		// The low pass as a filter, for its parameter defaults and pole/zero queries
+		virtual const Dsp::Filter& getLowPass() const = 0;
+
+		virtual const Dsp::Cascade& getLowPassCascade() const = 0;
+		virtual const Dsp::Cascade& getHighPassCascade() const = 0;
+	};
+
+	// Create the designs of a family (allocates, not for the audio thread)
+	Pair* createPair(int family);
+
+	// Parameters for a filter of the family, with the family's own defaults for its shape
+	Dsp::Params getParams(const Dsp::Filter& filter, double sampleRate, int order, double freq);
+}
+
+#endif  // CROSSOVERFILTERS_H_INCLUDED
@@ -0,0 +1,148 @@
+/*
+------------------------------------------------------------------------------
+
+Crossover split
+================
+A low and high pass split of up to two channels at one frequency.
+
+By Daniel Rothmann
+
+Provided under GNU General Public license:
+http://www.gnu.org/licenses/
+
+------------------------------------------------------------------------------
+*/
+
+#include "CrossoverSplit.h"
+
+//====================================================
+
+CrossoverSplit::CrossoverSplit(int family)
+{
+	designs = CrossoverFilters::createPair(family);
+	serviceDesigns = CrossoverFilters::createPair(family);
+}
+
+void CrossoverSplit::setParams(const Dsp::Params& newParams)
+{
+	designs->setParams(newParams);
+
+	Bank newBank;
+	newBank.setFilter(0, designs->getLowPassCascade());
+	newBank.setFilter(1, designs->getHighPassCascade());
+
+	// Anything the design thread is still working on is out of date now
+	takenSerial = ++lastSerial;
+
+	startTransition(newBank);
+}
+
+void CrossoverSplit::requestParams(const Dsp::Params& newParams)
+{
+	Request& request = requests.getWriteBuffer();
+	request.params = newParams;
+	request.serial = ++lastSerial;
+
+	requests.publish();
+}
+
+void CrossoverSplit::takeReadyDesign()
+{
+	if (! readyDesigns.update())
+		return;
+
+	const Design& design = readyDesigns.getReadBuffer();
+
+	if (design.serial > takenSerial)
+	{
+		takenSerial = design.serial;
+		startTransition(design.bank);
+	}
+}
+
+void CrossoverSplit::designRequested()
+{
+	if (! requests.update())
+		return;
+
+	const Request& request = requests.getReadBuffer();
+	serviceDesigns->setParams(request.params);
+
+	Design& design = readyDesigns.getWriteBuffer();
+	design.bank.setFilter(0, serviceDesigns->getLowPassCascade());
+	design.bank.setFilter(1, serviceDesigns->getHighPassCascade());
+	design.serial = request.serial;
+
+	readyDesigns.publish();
+}
+
+const Dsp::Filter& CrossoverSplit::getLowPass() const
+{
+	return designs->getLowPass();
+}
+
+void CrossoverSplit::reset()
+{
+	for (int channel = 0; channel < maxChannels; ++channel)
+	{
+		channels[channel].state.reset();
+		channels[channel].transitionPosition = transitionSamples;
+	}
+}
+
+void CrossoverSplit::startTransition(const Bank& newBank)
+{
+	// The first design takes effect at once
+	if (! isDesigned)
+	{
+		bank = newBank;
+		isDesigned = true;
+		return;
+	}
+
+	// Channels split together are in the same place of the transition, so the first one leads
+	const int position = channels[0].transitionPosition;
+
+	if (position < transitionSamples)
+		transitionBank.interpolate(transitionBank, bank, (double) position / transitionSamples);
+	else
+		transitionBank = bank;
+
+	bank = newBank;
+
+	for (int channel = 0; channel < maxChannels; ++channel)
+		channels[channel].transitionPosition = 0;
+}
+
+void CrossoverSplit::process(int numSamples, float* const* low, float* const* high, int firstChannel, int numChannels)
+{
+	jassert(firstChannel >= 0 && firstChannel + numChannels <= maxChannels);
+
+	// If this goes off it means setParams() was never called
+	jassert(isDesigned);
+
+	for (int channel = firstChannel; channel < firstChannel + numChannels; ++channel)
+	{
+		Channel& c = channels[channel];
+		int done = 0;
+
+		// Step through the transition, each step at the coefficients for its end
+		while (c.transitionPosition < transitionSamples && done < numSamples)
+		{
+			const int numToDo = jmin(rampStepSamples - c.transitionPosition % rampStepSamples, numSamples - done);
+			c.transitionPosition += numToDo;
+			c.rampBank.interpolate(transitionBank, bank, (double) c.transitionPosition / transitionSamples);
+
+			float* const outputs[2] = { low[channel] + done, high[channel] + done };
+			c.rampBank.process(numToDo, low[channel] + done, outputs, c.state);
+			done += numToDo;
+		}
+
+		// Do what's left at the current design
+		if (numSamples - done > 0)
+		{
+			float* const outputs[2] = { low[channel] + done, high[channel] + done };
+			bank.process(numSamples - done, low[channel] + done, outputs, c.state);
+		}
+	}
+}
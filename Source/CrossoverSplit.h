@@ -0,0 +1,119 @@
+/*
+------------------------------------------------------------------------------
+
+Crossover split
+================
+A low and high pass split of up to two channels at one frequency.
+
+The low and high pass of a channel read the same input, so both run through
+one Dsp::FilterBank, which reads every sample once and updates the two
+filters side by side in vector registers.
+
+A change of parameters is designed either at once by setParams() or on the
+design service's thread after requestParams(), which the audio thread can
+call without locks or allocation. Either way the new coefficients are taken
+up at a block boundary and the bank moves to them over transitionSamples
+samples, interpolating the coefficients every rampStepSamples. The audio
+thread never designs during a transition, however slow the family is to
+set up. Every channel keeps its own place in the transition, so that
+channels can be split on different threads.
+
+By Daniel Rothmann
+
+Provided under GNU General Public license:
+http://www.gnu.org/licenses/
+
+------------------------------------------------------------------------------
+*/
+
+#ifndef CROSSOVERSPLIT_H_INCLUDED
+#define CROSSOVERSPLIT_H_INCLUDED
+
+#include "../JuceLibraryCode/JuceHeader.h"
+#include "CrossoverFilters.h"
+#include "DspFilters/Dsp.h"
+#include "FilterDesignService.h"
+#include "TripleBuffer.h"
+
+class CrossoverSplit : public FilterDesignService::Client
+{
+public:
+	// Allocates the designs of the family, so not for the audio thread
+	CrossoverSplit(int family);
+
+	// Design at new parameters right away, moving there over a transition unless it is the
+	// first design (message thread, or the audio thread when rendering offline)
+	void setParams(const Dsp::Params& newParams);
+
+	// Ask for a design at new parameters, to be made on the design service's thread (audio thread, lock-free)
+	void requestParams(const Dsp::Params& newParams);
+
+	// Start the transition to the latest design made on the design service's thread, if any
+	// (audio thread, at a block boundary, before any channel is processed)
+	void takeReadyDesign();
+
+	// The low pass design, for the family's parameter defaults
+	const Dsp::Filter& getLowPass() const;
+
+	// Clear the filter state and skip any transition in progress
+	void reset();
+
+	// Split channels in place, leaving the low pass in low and writing the high pass to high
+	void process(int numSamples, float* const* low, float* const* high, int firstChannel, int numChannels);
+
+	static const int maxChannels = 2;
+	static const int transitionSamples = 1024;
+	static const int rampStepSamples = 16; // Divides transitionSamples
+
+private:
+	// Low pass first, then high pass
+	typedef Dsp::FilterBank<2, CrossoverFilters::maxStages> Bank;
+
+	// Parameters asked for and designs made from them, numbered so that a design made from
+	// a request that was overtaken by setParams() is never taken up
+	struct Request
+	{
+		Dsp::Params params;
+		int64 serial = 0;
+	};
+
+	struct Design
+	{
+		Bank bank;
+		int64 serial = 0;
+	};
+
+	void designRequested() override;
+
+	// Move to a new bank over a transition, from wherever the one in progress had got to
+	void startTransition(const Bank& newBank);
+
+	// Declare the designs made on the calling thread and the bank they were last moved to
+	ScopedPointer<CrossoverFilters::Pair> designs;
+	Bank bank;
+	bool isDesigned = false;
+
+	// Declare the bank a transition started from
+	Bank transitionBank;
+
+	// Declare the hand over to and from the design thread, which has designs of its own
+	TripleBuffer<Request> requests;
+	TripleBuffer<Design> readyDesigns;
+	ScopedPointer<CrossoverFilters::Pair> serviceDesigns;
+	int64 lastSerial = 0;
+	int64 takenSerial = 0;
+
+	// Declare per channel state, including the bank in use during a transition
+	struct Channel
+	{
+		Bank::State state;
+		Bank rampBank;
+		int transitionPosition = transitionSamples;
+	};
+
+	Channel channels[maxChannels];
+
+	JUCE_DECLARE_NON_COPYABLE(CrossoverSplit)
+};
+
+#endif  // CROSSOVERSPLIT_H_INCLUDED
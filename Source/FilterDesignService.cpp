@@ -0,0 +1,68 @@
+/*
+------------------------------------------------------------------------------
+
+Filter design service
+================
+A background thread designing filters the audio thread has asked for.
+
+By Daniel Rothmann
+
+Provided under GNU General Public license:
+http://www.gnu.org/licenses/
+
+------------------------------------------------------------------------------
+*/
+
+#include "FilterDesignService.h"
+
+//====================================================
+
+FilterDesignService::FilterDesignService()
+	: Thread("AIR filter design")
+{
+}
+
+FilterDesignService::~FilterDesignService()
+{
+	stop();
+}
+
+void FilterDesignService::start()
+{
+	if (! isThreadRunning())
+		startThread();
+}
+
+void FilterDesignService::stop()
+{
+	stopThread(1000);
+}
+
+void FilterDesignService::addClient(Client* client)
+{
+	const ScopedLock sl(clientLock);
+	clients.addIfNotAlreadyThere(client);
+}
+
+void FilterDesignService::removeClient(Client* client)
+{
+	// Waits for the client's design in progress, if there is one
+	const ScopedLock sl(clientLock);
+	clients.removeFirstMatchingValue(client);
+}
+
+void FilterDesignService::run()
+{
+	while (! threadShouldExit())
+	{
+		{
+			// Only the message thread ever takes this lock as well, never the audio thread
+			const ScopedLock sl(clientLock);
+
+			for (Client* client : clients)
+				client->designRequested();
+		}
+
+		wait(designInterval);
+	}
+}
@@ -0,0 +1,66 @@
+/*
+------------------------------------------------------------------------------
+
+Filter design service
+================
+A background thread designing filters the audio thread has asked for.
+
+Some designs (Elliptic, high order Legendre) take far longer to set up than
+the audio thread can spare when a parameter moves. Clients let the audio
+thread post the parameters it wants without locks, and the service looks
+for new requests every designInterval milliseconds, calling each client to
+design them and hand the coefficients back, again without locks. The
+audio thread takes them up at the next block boundary.
+
+Clients are added and removed on the message thread, which only ever waits
+for the design in progress, never for the audio thread.
+
+By Daniel Rothmann
+
+Provided under GNU General Public license:
+http://www.gnu.org/licenses/
+
+------------------------------------------------------------------------------
+*/
+
+#ifndef FILTERDESIGNSERVICE_H_INCLUDED
+#define FILTERDESIGNSERVICE_H_INCLUDED
+
+#include "../JuceLibraryCode/JuceHeader.h"
+
+class FilterDesignService : private Thread
+{
+public:
+	class Client
+	{
+	public:
+		virtual ~Client() {}
+
+		// Design whatever was asked for since the last call (design thread)
+		virtual void designRequested() = 0;
+	};
+
+	FilterDesignService();
+	~FilterDesignService();
+
+	// Start and stop the design thread (message thread)
+	void start();
+	void stop();
+
+	// Add or remove a client, which must not be deleted while it is added (message thread)
+	void addClient(Client* client);
+	void removeClient(Client* client);
+
+private:
+	void run() override;
+
+	Array<Client*> clients;
+	CriticalSection clientLock;
+
+	// How often the design thread looks for new requests, in milliseconds
+	static const int designInterval = 5;
+
+	JUCE_DECLARE_NON_COPYABLE(FilterDesignService)
+};
+
+#endif  // FILTERDESIGNSERVICE_H_INCLUDED
@@ -0,0 +1,217 @@
+/*
+------------------------------------------------------------------------------
+
+Linear phase crossover
+================
+A linear phase split of a stereo signal at the Roth-AIR crossover frequency.
+
+By Daniel Rothmann
+
+Provided under GNU General Public license:
+http://www.gnu.org/licenses/
+
+------------------------------------------------------------------------------
+*/
+
+#include "LinearPhaseCrossover.h"
+
+//====================================================
+
+LinearPhaseCrossover::LinearPhaseCrossover()
+	: Thread("AIR crossover design"), requestedFreq(0.0)
+{
+	for (int i = 0; i < numKernels; ++i)
+		kernelStates[i].store(kernelFree);
+}
+
+LinearPhaseCrossover::~LinearPhaseCrossover()
+{
+	release();
+}
+
+void LinearPhaseCrossover::prepare(double sampleRate, double crossFreq)
+{
+	release();
+
+	// Keep the transition band about as wide in Hz at any sample rate
+	currentSampleRate = sampleRate;
+	kernelLength = sampleRate <= 48000.0 ? 1023 : (sampleRate <= 96000.0 ? 2047 : 4095);
+
+	// The kernel is centred on its middle tap, and the convolver adds one block
+	latencySamples = (kernelLength - 1) / 2 + convolverBlockSize;
+
+	convolver.prepare(convolverBlockSize, kernelLength);
+	impulse.malloc(kernelLength);
+
+	for (int i = 0; i < numKernels; ++i)
+	{
+		convolver.allocateKernel(kernels[i]);
+		kernelStates[i].store(kernelFree);
+	}
+
+	// The first kernel is designed right here, so that the split works from the first block
+	designKernel(kernels[0], crossFreq);
+	kernelStates[0].store(kernelActive);
+	currentKernel = 0;
+	previousKernel = -1;
+	convolver.setKernel(&kernels[0]);
+
+	designedFreq = crossFreq;
+	requestedFreq.store(crossFreq);
+
+	delayBuffer.setSize(2, latencySamples);
+	reset();
+
+	startThread();
+}
+
+void LinearPhaseCrossover::release()
+{
+	stopThread(1000);
+}
+
+int LinearPhaseCrossover::getLatencySamples() const
+{
+	return latencySamples;
+}
+
+int LinearPhaseCrossover::getKernelLength() const
+{
+	return kernelLength;
+}
+
+void LinearPhaseCrossover::reset()
+{
+	convolver.reset();
+	delayBuffer.clear();
+	delayPos = 0;
+}
+
+void LinearPhaseCrossover::setCrossFreq(double newFreq)
+{
+	requestedFreq.store(newFreq);
+}
+
+void LinearPhaseCrossover::process(float* const* low, float* const* high, float* const* dry, int numDryChannels, int numSamples)
+{
+	jassert(numDryChannels <= 2);
+
+	takeReadyKernel();
+
+	// Delay the input by swapping it through the delay line
+	for (int channel = 0; channel < 2; ++channel)
+		FloatVectorOperations::copy(high[channel], low[channel], numSamples);
+
+	for (int done = 0; done < numSamples;)
+	{
+		const int numToDo = jmin(numSamples - done, latencySamples - delayPos);
+
+		for (int channel = 0; channel < 2; ++channel)
+			std::swap_ranges(high[channel] + done, high[channel] + done + numToDo, delayBuffer.getWritePointer(channel, delayPos));
+
+		delayPos = (delayPos + numToDo) % latencySamples;
+		done += numToDo;
+	}
+
+	// Low pass the input, which comes out with the same delay
+	convolver.process(low[0], low[1], numSamples);
+
+	for (int channel = 0; channel < numDryChannels; ++channel)
+		FloatVectorOperations::copy(dry[channel], high[channel], numSamples);
+
+	// Whatever isn't in the low band belongs to the high band
+	for (int channel = 0; channel < 2; ++channel)
+		FloatVectorOperations::subtract(high[channel], low[channel], numSamples);
+}
+
+void LinearPhaseCrossover::takeReadyKernel()
+{
+	// Wait for any crossfade to finish before taking the next kernel
+	if (convolver.isFading())
+		return;
+
+	// The outgoing kernel is done with, so the design thread can have it back
+	if (previousKernel >= 0)
+	{
+		kernelStates[previousKernel].store(kernelFree);
+		previousKernel = -1;
+	}
+
+	for (int i = 0; i < numKernels; ++i)
+	{
+		int expected = kernelReady;
+
+		if (kernelStates[i].compare_exchange_strong(expected, kernelActive))
+		{
+			previousKernel = currentKernel;
+			currentKernel = i;
+			convolver.fadeToKernel(&kernels[i], numFadeBlocks);
+			break;
+		}
+	}
+}
+
+void LinearPhaseCrossover::run()
+{
+	while (! threadShouldExit())
+	{
+		const double freq = requestedFreq.load();
+
+		if (freq != designedFreq)
+		{
+			// Claim a kernel that the audio thread isn't using
+			int slot = -1;
+
+			for (int i = 0; i < numKernels && slot < 0; ++i)
+			{
+				int expected = kernelFree;
+
+				if (kernelStates[i].compare_exchange_strong(expected, kernelDesigning))
+					slot = i;
+			}
+
+			if (slot >= 0)
+			{
+				designKernel(kernels[slot], freq);
+				designedFreq = freq;
+
+				// A kernel still waiting to be taken is out of date now
+				for (int i = 0; i < numKernels; ++i)
+				{
+					int expected = kernelReady;
+					kernelStates[i].compare_exchange_strong(expected, kernelFree);
+				}
+
+				kernelStates[slot].store(kernelReady);
+			}
+		}
+
+		wait(designInterval);
+	}
+}
+
+void LinearPhaseCrossover::designKernel(PartitionedConvolver::Kernel& kernel, double freq)
+{
+	// Blackman windowed sinc low pass, normalised to unity gain at DC
+	const double cutoff = freq / currentSampleRate;
+	const int middle = (kernelLength - 1) / 2;
+	double sum = 0.0;
+
+	for (int i = 0; i < kernelLength; ++i)
+	{
+		const double x = i - middle;
+		const double sinc = (i == middle)
+			? 2.0 * cutoff
+			: sin(2.0 * MathConstants<double>::pi * cutoff * x) / (MathConstants<double>::pi * x);
+
+		const double phase = 2.0 * MathConstants<double>::pi * i / (kernelLength - 1);
+		const double window = 0.42 - 0.5 * cos(phase) + 0.08 * cos(2.0 * phase);
+
+		impulse[i] = (float) (sinc * window);
+		sum += impulse[i];
+	}
+
+	FloatVectorOperations::multiply(impulse, (float) (1.0 / sum), kernelLength);
+
+	convolver.setImpulse(kernel, impulse, kernelLength);
+}
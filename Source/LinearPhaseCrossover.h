@@ -0,0 +1,106 @@
+/*
+------------------------------------------------------------------------------
+
+Linear phase crossover
+================
+A linear phase split of a stereo signal at the Roth-AIR crossover frequency.
+
+The low band is a windowed-sinc low pass run through the partitioned
+convolver, and the high band is the equally delayed input minus the low band,
+so both bands sum back to the delayed input exactly. Kernels are designed on
+a background thread whenever the crossover frequency moves, handed over
+without locks and crossfaded in by the convolver. The whole split is delayed
+by getLatencySamples(), which the dry path must be delayed by as well.
+
+By Daniel Rothmann
+
+Provided under GNU General Public license:
+http://www.gnu.org/licenses/
+
+------------------------------------------------------------------------------
+*/
+
+#ifndef LINEARPHASECROSSOVER_H_INCLUDED
+#define LINEARPHASECROSSOVER_H_INCLUDED
+
+#include "../JuceLibraryCode/JuceHeader.h"
+#include "PartitionedConvolver.h"
+#include <atomic>
+
+class LinearPhaseCrossover : private Thread
+{
+public:
+	LinearPhaseCrossover();
+	~LinearPhaseCrossover();
+
+	// Allocate for a sample rate, design the first kernel and start the design thread
+	void prepare(double sampleRate, double crossFreq);
+
+	// Stop the design thread
+	void release();
+
+	// Delay of both bands, in samples
+	int getLatencySamples() const;
+
+	// Extra ring-out of the low pass kernel after the input stops, in samples
+	int getKernelLength() const;
+
+	// Clear all signal history
+	void reset();
+
+	// Ask for a new crossover frequency (audio thread, lock-free)
+	void setCrossFreq(double newFreq);
+
+	// Split two channels: low holds the input and gets the low band, high gets the high band.
+	// The dry channels are replaced by the input delayed by the latency; each of them must
+	// hold the same signal as the low channel of the same index.
+	void process(float* const* low, float* const* high, float* const* dry, int numDryChannels, int numSamples);
+
+private:
+	enum KernelState
+	{
+		kernelFree = 0,
+		kernelDesigning,
+		kernelReady,
+		kernelActive
+	};
+
+	void run() override;
+
+	void designKernel(PartitionedConvolver::Kernel& kernel, double freq);
+	void takeReadyKernel();
+
+	PartitionedConvolver convolver;
+
+	// Current kernel, outgoing kernel while crossfading, and one being designed or waiting
+	static const int numKernels = 3;
+	PartitionedConvolver::Kernel kernels[numKernels];
+	std::atomic<int> kernelStates[numKernels];
+	int currentKernel = -1;
+	int previousKernel = -1;
+
+	// Blocks of the convolver to crossfade over when a new kernel comes in
+	static const int numFadeBlocks = 4;
+
+	// Partition size of the convolver
+	static const int convolverBlockSize = 128;
+
+	// How often the design thread looks for a new frequency, in milliseconds
+	static const int designInterval = 10;
+
+	std::atomic<double> requestedFreq;
+	double designedFreq = 0.0;
+
+	double currentSampleRate = 0.0;
+	int kernelLength = 0;
+	HeapBlock<float> impulse;
+
+	// Delay of the input matching the latency of the low band
+	AudioSampleBuffer delayBuffer;
+	int delayPos = 0;
+	int latencySamples = 0;
+
+	JUCE_DECLARE_NON_COPYABLE(LinearPhaseCrossover)
+};
+
+#endif  // LINEARPHASECROSSOVER_H_INCLUDED
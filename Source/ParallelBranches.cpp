@@ -0,0 +1,110 @@
+/*
+------------------------------------------------------------------------------
+
+Parallel branches
+================
+A small pool of worker threads for running independent branches of the
+Roth-AIR processing chain at the same time.
+
+By Daniel Rothmann
+
+Provided under GNU General Public license:
+http://www.gnu.org/licenses/
+
+------------------------------------------------------------------------------
+*/
+
+#include "ParallelBranches.h"
+
+//====================================================
+
+ParallelBranches::ParallelBranches(int numWorkers)
+	: nextBranch(0)
+{
+	jassert(numWorkers > 0);
+
+	for (int i = 0; i < numWorkers; ++i)
+	{
+		workers.add(new Worker(*this));
+		workers.getLast()->startThread();
+	}
+}
+
+ParallelBranches::~ParallelBranches()
+{
+	// Workers stop in their destructors
+	workers.clear();
+}
+
+void ParallelBranches::run(int numBranches, const Branch& branch)
+{
+	if (numBranches <= 0)
+		return;
+
+	currentBranch = &branch;
+	numCurrentBranches = numBranches;
+	nextBranch.store(0);
+
+	// The calling thread takes a share itself, so one worker less is needed
+	const int numStarted = jmin(workers.size(), numBranches - 1);
+
+	for (int i = 0; i < numStarted; ++i)
+		workers.getUnchecked(i)->start();
+
+	runRemainingBranches();
+
+	for (int i = 0; i < numStarted; ++i)
+		workers.getUnchecked(i)->waitUntilDone();
+
+	currentBranch = nullptr;
+}
+
+int ParallelBranches::getNumWorkers() const
+{
+	return workers.size();
+}
+
+void ParallelBranches::runRemainingBranches()
+{
+	for (int index = nextBranch.fetch_add(1); index < numCurrentBranches; index = nextBranch.fetch_add(1))
+		(*currentBranch)(index);
+}
+
+//====================================================
+
+ParallelBranches::Worker::Worker(ParallelBranches& owner)
+	: Thread("AIR branch worker"),
+	branches(owner)
+{
+}
+
+ParallelBranches::Worker::~Worker()
+{
+	signalThreadShouldExit();
+	startEvent.signal();
+	stopThread(2000);
+}
+
+void ParallelBranches::Worker::start()
+{
+	startEvent.signal();
+}
+
+void ParallelBranches::Worker::waitUntilDone()
+{
+	doneEvent.wait();
+}
+
+void ParallelBranches::Worker::run()
+{
+	for (;;)
+	{
+		startEvent.wait();
+
+		if (threadShouldExit())
+			return;
+
+		branches.runRemainingBranches();
+		doneEvent.signal();
+	}
+}
@@ -0,0 +1,75 @@
+/*
+------------------------------------------------------------------------------
+
+Parallel branches
+================
+A small pool of worker threads for running independent branches of the
+Roth-AIR processing chain at the same time.
+
+Only meant for offline rendering of large blocks: waking the workers costs
+far more than a realtime-sized block takes to process, and the workers are
+not realtime threads. Each run() hands out the branch indices to the workers
+and the calling thread, and returns once every branch has finished.
+
+By Daniel Rothmann
+
+Provided under GNU General Public license:
+http://www.gnu.org/licenses/
+
+------------------------------------------------------------------------------
+*/
+
+#ifndef PARALLELBRANCHES_H_INCLUDED
+#define PARALLELBRANCHES_H_INCLUDED
+
+#include "../JuceLibraryCode/JuceHeader.h"
+#include <atomic>
+#include <functional>
+
+class ParallelBranches
+{
+public:
+	typedef std::function<void(int branch)> Branch;
+
+	ParallelBranches(int numWorkers);
+	~ParallelBranches();
+
+	// Call branch once for every index below numBranches, spread over the workers
+	// and the calling thread, and wait until all of them have finished
+	void run(int numBranches, const Branch& branch);
+
+	int getNumWorkers() const;
+
+private:
+	class Worker : public Thread
+	{
+	public:
+		Worker(ParallelBranches& owner);
+		~Worker();
+
+		void start();
+		void waitUntilDone();
+
+		void run() override;
+
+	private:
+		ParallelBranches& branches;
+		WaitableEvent startEvent;
+		WaitableEvent doneEvent;
+
+		JUCE_DECLARE_NON_COPYABLE(Worker)
+	};
+
+	// Run branches until none are left (called by the workers and the calling thread)
+	void runRemainingBranches();
+
+	OwnedArray<Worker> workers;
+
+	const Branch* currentBranch = nullptr;
+	int numCurrentBranches = 0;
+	std::atomic<int> nextBranch;
+
+	JUCE_DECLARE_NON_COPYABLE(ParallelBranches)
+};
+
+#endif  // PARALLELBRANCHES_H_INCLUDED
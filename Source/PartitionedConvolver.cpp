@@ -0,0 +1,321 @@
+/*
+------------------------------------------------------------------------------
+
+Partitioned convolver
+================
+A uniformly partitioned overlap-save FFT convolution engine for Roth-AIR.
+
+By Daniel Rothmann
+
+Provided under GNU General Public license:
+http://www.gnu.org/licenses/
+
+------------------------------------------------------------------------------
+*/
+
+#include "PartitionedConvolver.h"
+
+//====================================================
+
+void PartitionedConvolver::FFT::prepare(int newSize)
+{
+	jassert(isPowerOfTwo(newSize));
+
+	size = newSize;
+
+	int numBits = 0;
+	while ((1 << numBits) < size)
+		++numBits;
+
+	bitReversed.malloc(size);
+
+	for (int i = 0; i < size; ++i)
+	{
+		int reversed = 0;
+
+		for (int bit = 0; bit < numBits; ++bit)
+			if (i & (1 << bit))
+				reversed |= 1 << (numBits - 1 - bit);
+
+		bitReversed[i] = reversed;
+	}
+
+	// A stage with half-length h keeps its h twiddles at offset h - 1
+	twiddleRe.malloc(jmax(1, size - 1));
+	twiddleIm.malloc(jmax(1, size - 1));
+
+	for (int half = 1; half < size; half <<= 1)
+	{
+		for (int j = 0; j < half; ++j)
+		{
+			const double angle = -MathConstants<double>::pi * j / half;
+			twiddleRe[half - 1 + j] = (float) cos(angle);
+			twiddleIm[half - 1 + j] = (float) sin(angle);
+		}
+	}
+}
+
+void PartitionedConvolver::FFT::forward(float* re, float* im) const
+{
+	for (int i = 0; i < size; ++i)
+	{
+		const int j = bitReversed[i];
+
+		if (i < j)
+		{
+			std::swap(re[i], re[j]);
+			std::swap(im[i], im[j]);
+		}
+	}
+
+	for (int half = 1; half < size; half <<= 1)
+	{
+		const float* wRe = twiddleRe + (half - 1);
+		const float* wIm = twiddleIm + (half - 1);
+
+		for (int start = 0; start < size; start += 2 * half)
+		{
+			float* aRe = re + start;
+			float* aIm = im + start;
+			float* bRe = aRe + half;
+			float* bIm = aIm + half;
+
+			for (int j = 0; j < half; ++j)
+			{
+				const float tRe = bRe[j] * wRe[j] - bIm[j] * wIm[j];
+				const float tIm = bRe[j] * wIm[j] + bIm[j] * wRe[j];
+
+				bRe[j] = aRe[j] - tRe;
+				bIm[j] = aIm[j] - tIm;
+				aRe[j] += tRe;
+				aIm[j] += tIm;
+			}
+		}
+	}
+}
+
+void PartitionedConvolver::FFT::inverse(float* re, float* im) const
+{
+	// Swapping real and imaginary parts turns the forward transform into the inverse
+	forward(im, re);
+}
+
+//====================================================
+
+PartitionedConvolver::PartitionedConvolver()
+{
+}
+
+void PartitionedConvolver::prepare(int newBlockSize, int maxImpulseLength)
+{
+	jassert(isPowerOfTwo(newBlockSize));
+
+	blockSize = newBlockSize;
+	fftSize = 2 * blockSize;
+	maxPartitions = jmax(1, (maxImpulseLength + blockSize - 1) / blockSize);
+
+	fft.prepare(fftSize);
+
+	windowRe.calloc(fftSize);
+	windowIm.calloc(fftSize);
+
+	delayLineRe.calloc(maxPartitions * fftSize);
+	delayLineIm.calloc(maxPartitions * fftSize);
+
+	accRe.calloc(fftSize);
+	accIm.calloc(fftSize);
+	fadeRe.calloc(fftSize);
+	fadeIm.calloc(fftSize);
+
+	outputLeft.calloc(blockSize);
+	outputRight.calloc(blockSize);
+
+	currentKernel = nullptr;
+	previousKernel = nullptr;
+
+	reset();
+}
+
+void PartitionedConvolver::allocateKernel(Kernel& kernel) const
+{
+	kernel.spectrumRe.calloc(maxPartitions * fftSize);
+	kernel.spectrumIm.calloc(maxPartitions * fftSize);
+	kernel.scratchRe.calloc(fftSize);
+	kernel.scratchIm.calloc(fftSize);
+	kernel.numPartitions = 0;
+	kernel.maxPartitions = maxPartitions;
+}
+
+void PartitionedConvolver::setImpulse(Kernel& kernel, const float* impulse, int length) const
+{
+	jassert(kernel.maxPartitions == maxPartitions);
+
+	kernel.numPartitions = jlimit(0, maxPartitions, (length + blockSize - 1) / blockSize);
+
+	for (int partition = 0; partition < kernel.numPartitions; ++partition)
+	{
+		const int start = partition * blockSize;
+		const int numTaps = jmin(blockSize, length - start);
+
+		// Overlap-save wants each partition in the first half, zero padded to the FFT size
+		FloatVectorOperations::clear(kernel.scratchRe, fftSize);
+		FloatVectorOperations::clear(kernel.scratchIm, fftSize);
+		FloatVectorOperations::copy(kernel.scratchRe, impulse + start, numTaps);
+
+		fft.forward(kernel.scratchRe, kernel.scratchIm);
+
+		FloatVectorOperations::copy(kernel.spectrumRe + partition * fftSize, kernel.scratchRe, fftSize);
+		FloatVectorOperations::copy(kernel.spectrumIm + partition * fftSize, kernel.scratchIm, fftSize);
+	}
+}
+
+void PartitionedConvolver::setKernel(const Kernel* kernel)
+{
+	currentKernel = kernel;
+	previousKernel = nullptr;
+}
+
+void PartitionedConvolver::fadeToKernel(const Kernel* kernel, int newNumFadeBlocks)
+{
+	if (currentKernel == nullptr || newNumFadeBlocks <= 0)
+	{
+		setKernel(kernel);
+		return;
+	}
+
+	previousKernel = currentKernel;
+	currentKernel = kernel;
+	numFadeBlocks = newNumFadeBlocks;
+	numFadedBlocks = 0;
+}
+
+bool PartitionedConvolver::isFading() const
+{
+	return previousKernel != nullptr;
+}
+
+void PartitionedConvolver::reset()
+{
+	FloatVectorOperations::clear(windowRe, fftSize);
+	FloatVectorOperations::clear(windowIm, fftSize);
+	FloatVectorOperations::clear(delayLineRe, maxPartitions * fftSize);
+	FloatVectorOperations::clear(delayLineIm, maxPartitions * fftSize);
+	FloatVectorOperations::clear(outputLeft, blockSize);
+	FloatVectorOperations::clear(outputRight, blockSize);
+
+	framePos = 0;
+	delayLinePos = 0;
+
+	// Finish any crossfade straight away
+	previousKernel = nullptr;
+}
+
+int PartitionedConvolver::getBlockSize() const
+{
+	return blockSize;
+}
+
+void PartitionedConvolver::process(float* left, float* right, int numSamples)
+{
+	while (numSamples > 0)
+	{
+		const int numToDo = jmin(numSamples, blockSize - framePos);
+
+		// Take in the new input and hand out the output of the last frame in its place
+		FloatVectorOperations::copy(windowRe + blockSize + framePos, left, numToDo);
+		FloatVectorOperations::copy(windowIm + blockSize + framePos, right, numToDo);
+		FloatVectorOperations::copy(left, outputLeft + framePos, numToDo);
+		FloatVectorOperations::copy(right, outputRight + framePos, numToDo);
+
+		framePos += numToDo;
+		left += numToDo;
+		right += numToDo;
+		numSamples -= numToDo;
+
+		if (framePos == blockSize)
+		{
+			processFrame();
+			framePos = 0;
+		}
+	}
+}
+
+void PartitionedConvolver::processFrame()
+{
+	// Transform the last two blocks into the newest slot of the delay line
+	float* spectrumRe = delayLineRe + delayLinePos * fftSize;
+	float* spectrumIm = delayLineIm + delayLinePos * fftSize;
+
+	FloatVectorOperations::copy(spectrumRe, windowRe, fftSize);
+	FloatVectorOperations::copy(spectrumIm, windowIm, fftSize);
+	fft.forward(spectrumRe, spectrumIm);
+
+	// Only the second half of the inverse transform is free of circular wrap-around
+	const float scale = 1.0f / fftSize;
+
+	if (currentKernel != nullptr)
+	{
+		multiplyAccumulate(*currentKernel, accRe, accIm);
+		fft.inverse(accRe, accIm);
+
+		FloatVectorOperations::multiply(outputLeft, accRe + blockSize, scale, blockSize);
+		FloatVectorOperations::multiply(outputRight, accIm + blockSize, scale, blockSize);
+	}
+	else
+	{
+		FloatVectorOperations::clear(outputLeft, blockSize);
+		FloatVectorOperations::clear(outputRight, blockSize);
+	}
+
+	// While crossfading, the outgoing kernel runs on the same input spectra
+	if (previousKernel != nullptr)
+	{
+		multiplyAccumulate(*previousKernel, fadeRe, fadeIm);
+		fft.inverse(fadeRe, fadeIm);
+
+		const float fadeLength = (float) (numFadeBlocks * blockSize);
+		const float fadeStart = (float) (numFadedBlocks * blockSize);
+
+		for (int i = 0; i < blockSize; ++i)
+		{
+			const float newGain = (fadeStart + i + 1) / fadeLength;
+			const float oldLeft = fadeRe[blockSize + i] * scale;
+			const float oldRight = fadeIm[blockSize + i] * scale;
+
+			outputLeft[i] = oldLeft + newGain * (outputLeft[i] - oldLeft);
+			outputRight[i] = oldRight + newGain * (outputRight[i] - oldRight);
+		}
+
+		if (++numFadedBlocks >= numFadeBlocks)
+			previousKernel = nullptr;
+	}
+
+	// Slide the input window along by one block
+	FloatVectorOperations::copy(windowRe, windowRe + blockSize, blockSize);
+	FloatVectorOperations::copy(windowIm, windowIm + blockSize, blockSize);
+
+	delayLinePos = (delayLinePos + 1) % maxPartitions;
+}
+
+void PartitionedConvolver::multiplyAccumulate(const Kernel& kernel, float* sumRe, float* sumIm) const
+{
+	FloatVectorOperations::clear(sumRe, fftSize);
+	FloatVectorOperations::clear(sumIm, fftSize);
+
+	// Partition p of the kernel meets the input spectrum from p blocks ago
+	for (int partition = 0; partition < kernel.numPartitions; ++partition)
+	{
+		const int slot = (delayLinePos - partition + maxPartitions) % maxPartitions;
+
+		const float* xRe = delayLineRe + slot * fftSize;
+		const float* xIm = delayLineIm + slot * fftSize;
+		const float* hRe = kernel.spectrumRe + partition * fftSize;
+		const float* hIm = kernel.spectrumIm + partition * fftSize;
+
+		for (int bin = 0; bin < fftSize; ++bin)
+		{
+			sumRe[bin] += xRe[bin] * hRe[bin] - xIm[bin] * hIm[bin];
+			sumIm[bin] += xRe[bin] * hIm[bin] + xIm[bin] * hRe[bin];
+		}
+	}
+}
@@ -0,0 +1,138 @@
+/*
+------------------------------------------------------------------------------
+
+Partitioned convolver
+================
+A uniformly partitioned overlap-save FFT convolution engine for Roth-AIR.
+
+The impulse response is cut into partitions of the block size, and each
+partition's spectrum is kept in a Kernel. Incoming blocks are transformed
+once and kept in a frequency domain delay line, so every block costs one
+forward and one inverse FFT plus a complex multiply-add per partition.
+Two channels share each transform by going in as the real and imaginary
+parts, which works because the impulse response is real. All spectra are
+stored as separate real and imaginary arrays, so the inner loops vectorize.
+
+The output is delayed by one block. Kernels can be swapped with a crossfade
+while running; the convolver never allocates outside prepare().
+
+By Daniel Rothmann
+
+Provided under GNU General Public license:
+http://www.gnu.org/licenses/
+
+------------------------------------------------------------------------------
+*/
+
+#ifndef PARTITIONEDCONVOLVER_H_INCLUDED
+#define PARTITIONEDCONVOLVER_H_INCLUDED
+
+#include "../JuceLibraryCode/JuceHeader.h"
+
+class PartitionedConvolver
+{
+public:
+	// Spectra of an impulse response, one per partition
+	class Kernel
+	{
+	public:
+		int getNumPartitions() const { return numPartitions; }
+
+	private:
+		friend class PartitionedConvolver;
+
+		HeapBlock<float> spectrumRe;
+		HeapBlock<float> spectrumIm;
+		int numPartitions = 0;
+		int maxPartitions = 0;
+
+		// Transform space, so kernels can be set up on any thread
+		HeapBlock<float> scratchRe;
+		HeapBlock<float> scratchIm;
+	};
+
+	PartitionedConvolver();
+
+	// Allocate for a block size (a power of two) and the longest impulse response to be used
+	void prepare(int newBlockSize, int maxImpulseLength);
+
+	// Allocate a kernel for this convolver (not realtime safe)
+	void allocateKernel(Kernel& kernel) const;
+
+	// Transform an impulse response into a kernel. Safe to call from another thread
+	// while processing, as long as the kernel itself is not in use.
+	void setImpulse(Kernel& kernel, const float* impulse, int length) const;
+
+	// Use a kernel from the next block on, without a crossfade
+	void setKernel(const Kernel* kernel);
+
+	// Crossfade from the current kernel to a new one over a number of blocks
+	void fadeToKernel(const Kernel* kernel, int numFadeBlocks);
+	bool isFading() const;
+
+	// Clear all input and output history
+	void reset();
+
+	int getBlockSize() const;
+
+	// Convolve two channels in place (output delayed by one block)
+	void process(float* left, float* right, int numSamples);
+
+private:
+	// Radix-2 FFT on split complex data
+	class FFT
+	{
+	public:
+		void prepare(int newSize);
+
+		// In-place transforms (unscaled)
+		void forward(float* re, float* im) const;
+		void inverse(float* re, float* im) const;
+
+	private:
+		int size = 0;
+		HeapBlock<int> bitReversed;
+
+		// Twiddle factors stage by stage, contiguous within each stage
+		HeapBlock<float> twiddleRe;
+		HeapBlock<float> twiddleIm;
+	};
+
+	void processFrame();
+	void multiplyAccumulate(const Kernel& kernel, float* accRe, float* accIm) const;
+
+	FFT fft;
+
+	int blockSize = 0;
+	int fftSize = 0;
+	int maxPartitions = 0;
+
+	// Last two blocks of input, left channel in the real part and right in the imaginary
+	HeapBlock<float> windowRe;
+	HeapBlock<float> windowIm;
+	int framePos = 0;
+
+	// Frequency domain delay line of input spectra
+	HeapBlock<float> delayLineRe;
+	HeapBlock<float> delayLineIm;
+	int delayLinePos = 0;
+
+	// Accumulators for the current and the outgoing kernel
+	HeapBlock<float> accRe;
+	HeapBlock<float> accIm;
+	HeapBlock<float> fadeRe;
+	HeapBlock<float> fadeIm;
+
+	// Output of the last frame
+	HeapBlock<float> outputLeft;
+	HeapBlock<float> outputRight;
+
+	const Kernel* currentKernel = nullptr;
+	const Kernel* previousKernel = nullptr;
+	int numFadeBlocks = 0;
+	int numFadedBlocks = 0;
+
+	JUCE_DECLARE_NON_COPYABLE(PartitionedConvolver)
+};
+
+#endif  // PARTITIONEDCONVOLVER_H_INCLUDED
@@ -137,6 +137,22 @@ void AirAudioProcessorEditor::paint (Graphics& g)
 	g.endTransparencyLayer();
 
 	g.drawImage(airText, 230, 164, 120, 72, 0, 0, 120, 72);
+
+   #if AIR_STAGE_PROFILING
+	// Draw the per-stage timings as a diagnostics overlay
+	const StageProfiler& profiler = processor.getStageProfiler();
+	g.setFont(11.0f);
+
+	for (int stage = 0; stage < StageProfiler::numStages; ++stage)
+	{
+		const StageProfiler::Stats stats = profiler.getStats(stage);
+		String line;
+		line << StageProfiler::getStageName(stage) << ": "
+			<< String(stats.minMs, 3) << " / " << String(stats.meanMs, 3) << " / " << String(stats.p99Ms, 3) << " ms";
+
+		g.drawText(line, 5, 285 + stage * 13, 200, 13, juce::Justification::centredLeft);
+	}
+   #endif
 }
 
 void AirAudioProcessorEditor::resized()
@@ -247,6 +263,11 @@ void AirAudioProcessorEditor::timerCallback()
 	gainSlider.setValue(processor.getHpGain(), dontSendNotification);
 	airSlider.setValue(processor.getAirAmt(), dontSendNotification);
 
+   #if AIR_STAGE_PROFILING
+	// Refresh the diagnostics overlay
+	repaint(5, 285, 200, 13 * StageProfiler::numStages);
+   #endif
+
 	// get current amount of gain reduction from compressor, divide it by 20(dB) and waveshape it for low values to be pushed up
 	double tempGainReduction = processor.getTempGainReduction() / 15;
 	tempGainReduction = (1.0 + 4) * tempGainReduction / (1.0 + 4 * abs(tempGainReduction));
@@ -41,24 +41,41 @@ AirAudioProcessor::AirAudioProcessor()
 													"Air Amt",
 													NormalisableRange<float>(0.0f, 1.0f),
 													0.0f));
+	addParameter(numBands = new AudioParameterInt("bands",
+													"Bands",
+													2, maxBands,
+													2));
 
     // Initialize non-parameter variables
 	hpPreGain = 0.0;
 	cRatio = 1.0;
-	airRatioAmt = 3.0;
 	airGainAmt = 0.0;
-	airSatAmt = 0.5;
     
     // Instanciate filters
-    hp = new Dsp::SmoothedFilterDesign <Dsp::Bessel::Design::HighPass<4>, 2, Dsp::DirectFormII>(1024);
-    lp = new Dsp::SmoothedFilterDesign <Dsp::Bessel::Design::LowPass<4>, 2, Dsp::DirectFormII>(1024);
+    crossover = new CrossoverSplit(crossoverFamily);
 
-    // Instanciate waveshaper
-    waveShaper = new WaveShaper(2);
+	// Instanciate the filters for the lower band splits
+	for (int split = 0; split < maxBands - 2; ++split)
+	{
+		splits.add(new CrossoverSplit(crossoverFamily));
+		splitFreq[split] = 0.0;
+	}
+
+	// Let the design thread serve the filters (started while prepared)
+	designService.addClient(crossover);
+
+	for (CrossoverSplit* split : splits)
+		designService.addClient(split);
+
+    // Instanciate waveshaper (two channels per air band)
+    waveShaper = new WaveShaper(2 * maxAirBands);
     waveShaper->setAmount(0.0);
 
-    // Instanciate compressor
-    pCompressor = new Compressor(2, 44100);
+    // Instanciate compressor (two channels per air band)
+    pCompressor = new Compressor(2 * maxAirBands, 44100);
+
+	// Instanciate linear phase crossover
+	linearCrossover = new LinearPhaseCrossover();
 	
 }
 
@@ -92,7 +109,7 @@ bool AirAudioProcessor::producesMidi() const
 
 double AirAudioProcessor::getTailLengthSeconds() const
 {
-    return 0.0;
+    return tailLengthSeconds;
 }
 
 int AirAudioProcessor::getNumPrograms()
@@ -125,20 +142,16 @@ void AirAudioProcessor::prepareToPlay(double sampleRate, int samplesPerBlock)
 	// Use this method as the place to do any pre-playback
 	// initialisation that you need..
 
-	// Initialize filter parameters
-	filterParams[0] = sampleRate; // Set sample rate
-	filterParams[1] = 2; // Set order
-	filterParams[2] = *crossFreq; // Set center freq
-	filterParams[3] = 1600; // Set bandwidth
+	// Pick the DSP kernels for this CPU (or the instruction set forced for testing)
+	Dsp::CpuDispatch::select();
 
-	// Set filter parameters
-	lp->setParams(filterParams);
-	hp->setParams(filterParams);
+	// Design the crossover and the lower split filters for the current band count
+	designCrossoverFilters(sampleRate);
 
 	// Initialize compressor
     pCompressor->setSampleRate(sampleRate);
 	pCompressor->setThreshold(*cThreshold);
-	pCompressor->setRatio(1.0 + (airRatioAmt * *airAmt));
+	pCompressor->setRatio(1.0 + (bandRatioAmt[0] * *airAmt));
     pCompressor->setAttackRate(0);
 	pCompressor->setReleaseRate(75);
 	pCompressor->setMakeupGain(0);
@@ -147,15 +160,61 @@ void AirAudioProcessor::prepareToPlay(double sampleRate, int samplesPerBlock)
 	// Initialize waveshaper
 	waveShaper->setAmount(0.0);
     
-	// Preallocate buffer memory
-	hpBuffer.setSize(2, samplesPerBlock);
-	lpBuffer.setSize(2, samplesPerBlock);
+	// Preallocate aligned scratch for the largest chunk, whatever the host block size. That is
+	// one internal chunk, unless offline blocks are large enough to be split over the worker pool.
+	const bool canRunInParallel = isNonRealtime() && samplesPerBlock >= minParallelBlockSize;
+	const int scratchSize = canRunInParallel ? minParallelBlockSize : internalChunkSize;
+
+	bandStorage.setSize(2 * maxAirBands, scratchSize);
+	lpStorage.setSize(2, scratchSize);
+	bandBuffer.setDataToReferTo(bandStorage.getArrayOfWritePointers(), bandStorage.getNumChannels(), bandStorage.getNumSamples());
+	lpBuffer.setDataToReferTo(lpStorage.getArrayOfWritePointers(), lpStorage.getNumChannels(), lpStorage.getNumSamples());
+
+	// Set up the crossover in use and report its latency, with the waveshaper's
+	prepareCrossover(sampleRate);
+	setLatencySamples(getLatency());
+
+	// Work out how long the chain takes to settle after the input stops
+	updateTailLength(sampleRate);
+
+	// Start from a clean state, so that identical input renders identical output
+	reset();
+
+	designService.start();
+
+	silentSamples = 0;
+	isSleeping = false;
+	isPrepared = true;
 }
 
 void AirAudioProcessor::releaseResources()
 {
     // When playback stops, you can use this as an opportunity to free up any
     // spare memory, etc.
+	linearCrossover->release();
+	designService.stop();
+	isPrepared = false;
+}
+
+void AirAudioProcessor::reset()
+{
+	// Clear all filter, envelope and buffer state
+	crossover->reset();
+
+	for (int split = 0; split < maxBands - 2; ++split)
+		splits[split]->reset();
+
+	pCompressor->resetSideChain();
+	waveShaper->reset();
+
+	if (crossoverMode == crossoverLinearPhase)
+		linearCrossover->reset();
+
+	bandBuffer.clear();
+	lpBuffer.clear();
+
+	for (int channel = 0; channel < 2; ++channel)
+		lpDelay[channel] = dryDelay[channel] = 0.0f;
 }
 
 #ifndef JucePlugin_PreferredChannelConfigurations
@@ -185,71 +244,387 @@ bool AirAudioProcessor::setPreferredBusArrangement (bool isInput, int bus, const
 
 void AirAudioProcessor::processBlock (AudioSampleBuffer& buffer, MidiBuffer& midiMessages)
 {
+	// Record any allocation or lock from here on (diagnostic builds only)
+	AIR_REALTIME_SECTION
+
     const int totalNumInputChannels  = getTotalNumInputChannels();
     const int totalNumOutputChannels = getTotalNumOutputChannels();
 	int numSamples = buffer.getNumSamples();
     
     jassert((totalNumInputChannels == 1) || (totalNumInputChannels == 2));
 	
-    // Clear buffer in case of garbage
-    for (int i = totalNumInputChannels; i < totalNumOutputChannels; ++i)
-        buffer.clear (i, 0, numSamples);
-    
-	// Copy buffer data into cross filter buffers
-    if(totalNumInputChannels == 2)
-    {
-        // If we're running stereo (2,2), copy each channel of the input buffer
-		hpBuffer.copyFrom(0, 0, buffer, 0, 0, numSamples);
-		hpBuffer.copyFrom(1, 0, buffer, 1, 0, numSamples);
-		lpBuffer.copyFrom(0, 0, buffer, 0, 0, numSamples);
-		lpBuffer.copyFrom(1, 0, buffer, 1, 0, numSamples);
-    }
-    else if (totalNumInputChannels == 1)
-    {
-        // If we're running mono (1,1) copy input channel into both output channels (workaround)
-        hpBuffer.copyFrom(0, 0, buffer, 0, 0, numSamples);
-        hpBuffer.copyFrom(1, 0, buffer, 0, 0, numSamples);
-        lpBuffer.copyFrom(0, 0, buffer, 0, 0, numSamples);
-        lpBuffer.copyFrom(1, 0, buffer, 0, 0, numSamples);
-    }
-
-	// Set filter crossover param every block
-	filterParams[2] = *crossFreq; // Set center freq
-	lp->setParams(filterParams);
-	hp->setParams(filterParams);
-
-	// Apply the filters to respective buffers
-	hp->process(numSamples, hpBuffer.getArrayOfWritePointers());
-	lp->process(numSamples, lpBuffer.getArrayOfWritePointers());
-
-	// Set waveshaper params and apply it
-	waveShaper->setAmount(*airAmt * airSatAmt);
-	waveShaper->processBlock(hpBuffer);
-    
-	// Set compressor parameters and apply it
-	tempRatio = 1.0 + (airRatioAmt * *airAmt);
-	pCompressor->setThreshold(*cThreshold);
-	pCompressor->setRatio(tempRatio);
-	pCompressor->processBlock(hpBuffer);
+	// Clear buffer in case of garbage
+	for (int i = totalNumInputChannels; i < totalNumOutputChannels; ++i)
+		buffer.clear (i, 0, numSamples);
+
+	// Sleep through silence once every filter and envelope has settled, passing the input through
+	if (buffer.getMagnitude(0, numSamples) <= silenceThreshold)
+	{
+		silentSamples += numSamples;
+
+		if (silentSamples > tailSamples)
+		{
+			// Clear the decayed state, so that waking up starts from scratch
+			if (! isSleeping)
+			{
+				reset();
+				isSleeping = true;
+			}
+
+			return;
+		}
+	}
+	else
+	{
+		// Wake up on the first block with any signal
+		silentSamples = 0;
+		isSleeping = false;
+	}
+
+	// Spread the independent branches over worker threads when rendering large blocks offline,
+	// if the scratch was sized for it when preparing
+	const bool runInParallel = isNonRealtime() && numSamples >= minParallelBlockSize && SystemStats::getNumCpus() > 1
+		&& bandBuffer.getNumSamples() >= minParallelBlockSize;
+
+	if (runInParallel && parallelBranches == nullptr)
+		parallelBranches = new ParallelBranches(jlimit(1, 2 * maxAirBands - 1, SystemStats::getNumCpus() - 1));
+
+	// Work through the block in fixed size chunks, so that the cost per sample doesn't depend
+	// on the host block size and the scratch buffers are never overrun
+	const int chunkSize = runInParallel ? minParallelBlockSize : internalChunkSize;
+
+	// The stage timers in processChunk add up over the chunks and are recorded once for the block
+	AIR_PROFILE_BLOCK(stageProfiler)
+
+	for (int start = 0; start < numSamples; start += chunkSize)
+	{
+		// Refer to part of the host buffer (no allocation for this few channels)
+		AudioSampleBuffer chunk(buffer.getArrayOfWritePointers(), buffer.getNumChannels(), start, jmin(chunkSize, numSamples - start));
+		processChunk(chunk, runInParallel);
+	}
+}
+
+void AirAudioProcessor::processChunk(AudioSampleBuffer& buffer, bool runInParallel)
+{
+	const int totalNumInputChannels = getTotalNumInputChannels();
+	const int numSamples = buffer.getNumSamples();
+
+	jassert(numSamples <= bandBuffer.getNumSamples());
+
+	// Number of bands this chunk, all but the lowest of which are processed
+	const int bands = *numBands;
+	const int airBands = bands - 1;
+
+	{
+		AIR_PROFILE_STAGE(stageProfiler, StageProfiler::stageCrossover)
+
+		// Copy buffer data into the low band, which the crossover splits in place
+		if(totalNumInputChannels == 2)
+		{
+			// If we're running stereo (2,2), copy each channel of the input buffer
+			lpBuffer.copyFrom(0, 0, buffer, 0, 0, numSamples);
+			lpBuffer.copyFrom(1, 0, buffer, 1, 0, numSamples);
+		}
+		else if (totalNumInputChannels == 1)
+		{
+			// If we're running mono (1,1) copy input channel into both output channels (workaround)
+			lpBuffer.copyFrom(0, 0, buffer, 0, 0, numSamples);
+			lpBuffer.copyFrom(1, 0, buffer, 0, 0, numSamples);
+		}
+
+		// Redesign the crossover only when it has moved, as each redesign starts a new transition
+		if (crossoverMode == crossoverBessel && filterParams[2] != *crossFreq)
+		{
+			filterParams[2] = *crossFreq; // Set center freq
+			redesign(*crossover, filterParams);
+		}
+
+		// Start splits that come into use from a clean state
+		if (bands != currentNumBands)
+		{
+			for (int split = currentNumBands - 2; split < bands - 2; ++split)
+				splits[split]->reset();
+
+			currentNumBands = bands;
+		}
+
+		updateSplitFilters(bands);
+
+		// Move to any designs the design thread has finished, all channels together
+		crossover->takeReadyDesign();
+
+		for (int split = 0; split < maxBands - 2; ++split)
+			splits[split]->takeReadyDesign();
+
+		// Apply the filters to respective buffers
+		if (crossoverMode == crossoverLinearPhase)
+		{
+			// Split at the crossover in linear phase, delaying the dry input by as much
+			linearCrossover->setCrossFreq(*crossFreq);
+			linearCrossover->process(lpBuffer.getArrayOfWritePointers(), bandBuffer.getArrayOfWritePointers(),
+									 buffer.getArrayOfWritePointers(), totalNumInputChannels, numSamples);
+
+			splitLowBands(0, 2, numSamples, airBands);
+		}
+		else if (runInParallel)
+		{
+			// Both bands of a channel come out of one pass, so each channel is a branch
+			parallelBranches->run(2, [&](int channel)
+			{
+				splitBands(channel, 1, numSamples, airBands);
+			});
+		}
+		else
+		{
+			splitBands(0, 2, numSamples, airBands);
+		}
+	}
+
+	// Set band parameters, bypassing bands whose settings leave the signal untouched
+	tempRatio = 1.0 + (bandRatioAmt[0] * *airAmt);
+
+	for (int band = 0; band < maxAirBands; ++band)
+	{
+		const double bandRatio = 1.0 + (bandRatioAmt[band] * *airAmt);
+		const double bandSat = *airAmt * bandSatAmt[band];
+		const bool isUsed = band < airBands;
+
+		for (int channel = 2 * band; channel < 2 * band + 2; ++channel)
+		{
+			waveShaper->setAmount(channel, isUsed ? bandSat : 0.0);
+			pCompressor->setThreshold(channel, *cThreshold + bandThresholdOffset[band]);
+			pCompressor->setRatio(channel, bandRatio);
+			pCompressor->setChannelActive(channel, isUsed && bandRatio != 1.0);
+		}
+	}
+
+	// Refer to the channels of the air bands in use (no allocation for this few channels)
+	AudioSampleBuffer airBuffer(bandBuffer.getArrayOfWritePointers(), 2 * airBands, numSamples);
+
+	if (runInParallel)
+	{
+		// The shaper runs inside the compressor branches here, so its time is counted there
+		AIR_PROFILE_STAGE(stageProfiler, StageProfiler::stageCompressor)
+
+		// Channels are shaped and compressed independently (unlinked), so each one is a branch
+		parallelBranches->run(airBuffer.getNumChannels(), [&](int channel)
+		{
+			waveShaper->processChannels(airBuffer, channel, 1);
+			pCompressor->processChannels(airBuffer, channel, 1);
+		});
+	}
+	else
+	{
+		{
+			AIR_PROFILE_STAGE(stageProfiler, StageProfiler::stageWaveShaper)
+
+			// Apply the waveshaper to all air bands at once
+			waveShaper->processBlock(airBuffer);
+		}
+
+		{
+			AIR_PROFILE_STAGE(stageProfiler, StageProfiler::stageCompressor)
+
+			// Apply the compressor to all air bands at once
+			pCompressor->processBlock(airBuffer);
+		}
+	}
+
+	{
+		AIR_PROFILE_STAGE(stageProfiler, StageProfiler::stageMix)
+
+		// Mix the buffers together and apply Dry/Wet for each channel, with the DSPFilters
+		// kernels for the instruction set selected in prepareToPlay
+		const float airGain = (float) (*hpGain + (*airAmt * airGainAmt));
+		const float wetGain = *dryWet;
+		const float dryGain = (float) (1.0 - *dryWet);
+
+		// The antialiasing modes delay the air bands by a sample, so hold the others back as much
+		const bool isShaperDelayed = waveShaper->getLatencySamples() > 0;
+
+		for (int channel = 0; channel < totalNumInputChannels; ++channel)
+		{
+			float* wet = bandBuffer.getWritePointer(channel);
+			float* dry = buffer.getWritePointer(channel);
+
+			if (isShaperDelayed)
+			{
+				delayByOneSample(lpBuffer.getWritePointer(channel), numSamples, lpDelay[channel]);
+				delayByOneSample(dry, numSamples, dryDelay[channel]);
+			}
+
+			// Sum the lower air bands into the top one
+			for (int band = 1; band < airBands; ++band)
+				Dsp::add(numSamples, wet, bandBuffer.getReadPointer(2 * band + channel));
+
+			// Apply post gain to air bands
+			Dsp::multiply(numSamples, wet, airGain);
+
+			// Add lpBuffer to bandBuffer (after processing the air bands)
+			Dsp::add(numSamples, wet, lpBuffer.getReadPointer(channel));
+
+			// WET GAIN
+			Dsp::multiply(numSamples, wet, wetGain);
+			// DRY GAIN
+			// The dry path needs no phase matching: the Bessel low and high pass sum to within
+			// +/-9 degrees of the input, swinging both ways and back to zero at DC and Nyquist.
+			// An allpass only ever lags, so any allpass built from the crossover poles would
+			// comb against the wet path far worse (down to -19 dB at an even mix) than the
+			// plain input does (-1.2 dB, all of it the wet path's own magnitude ripple).
+			Dsp::multiply(numSamples, dry, dryGain);
+
+			// Add wet signal to buffer
+			Dsp::add(numSamples, dry, wet);
+		}
+	}
+}
+
+void AirAudioProcessor::designCrossoverFilters(double sampleRate)
+{
+	// Initialize filter parameters (sample rate, order and center freq), keeping the family's own shape
+	filterParams = CrossoverFilters::getParams(crossover->getLowPass(), sampleRate, crossoverOrder, *crossFreq);
+
+	// Set filter parameters. This designs the analog prototype into the shared
+	// cache, so that split filters set up later only look it up. The elliptic
+	// shape is the library default, so it takes one of the shaped entries per order.
+	crossover->setParams(filterParams);
+
+	// Design every lower split, each one in use for the current band count where it belongs and
+	// the rest where they'd be with the fewest bands that use them, so none is ever undesigned
+	currentNumBands = *numBands;
+
+	for (int split = 1; split < maxBands - 1; ++split)
+	{
+		Dsp::Params splitParams = filterParams;
+		splitParams[2] = splitFreq[split - 1] = getSplitFreq(split, jmax(currentNumBands, split + 2));
+
+		splits[split - 1]->setParams(splitParams);
+	}
+}
+
+void AirAudioProcessor::updateTailLength(double sampleRate)
+{
+	// The slowest filter is the lowest split in use, so find its largest pole radius
+	ScopedPointer<CrossoverFilters::Pair> slowestFilters = CrossoverFilters::createPair(crossoverFamily);
+	slowestFilters->setParams(CrossoverFilters::getParams(slowestFilters->getLowPass(), sampleRate, crossoverOrder,
+														  jmin((double) crossFreq->range.start, lowestSplitFreq)));
+
+	double poleRadius = 0.0;
+
+	for (const Dsp::PoleZeroPair& pair : slowestFilters->getLowPass().getPoleZeros())
+		poleRadius = jmax(poleRadius, std::abs(pair.poles.first), std::abs(pair.poles.second));
+
+	// Ring-down of the crossover to the silence threshold, in samples
+	const double filterTailSamples = (poleRadius > 0.0 && poleRadius < 1.0)
+		? log((double) silenceThreshold) / log(poleRadius)
+		: 0.0;
+
+	// Release from the largest gain reduction the controls allow (full scale input, lowest threshold, steepest band)
+	double maxRatioAmt = 0.0;
+	double minThresholdOffset = 0.0;
+
+	for (int band = 0; band < maxAirBands; ++band)
+	{
+		maxRatioAmt = jmax(maxRatioAmt, bandRatioAmt[band]);
+		minThresholdOffset = jmin(minThresholdOffset, bandThresholdOffset[band]);
+	}
+
+	const double maxRatio = 1.0 + maxRatioAmt;
+	const double maxGainReduction = (20.0 - (cThreshold->range.start + minThresholdOffset)) * (1.0 - 1.0 / maxRatio);
+
+	tailLengthSeconds = filterTailSamples / sampleRate + pCompressor->getFullReleaseSeconds(maxGainReduction);
 
-	// Apply post gain to air buffer
-	hpBuffer.applyGain(*hpGain + (*airAmt * airGainAmt));
+	// The linear phase split rings out for its latency plus the length of its kernel
+	if (crossoverMode == crossoverLinearPhase)
+		tailLengthSeconds += (linearCrossover->getLatencySamples() + linearCrossover->getKernelLength()) / sampleRate;
+	tailSamples = (int64) ceil(tailLengthSeconds * sampleRate);
+}
+
+void AirAudioProcessor::splitBands(int firstChannel, int numChannels, int numSamples, int airBands)
+{
+	// Split the input at the crossover, the high pass being the first air band
+	crossover->process(numSamples, lpBuffer.getArrayOfWritePointers(), bandBuffer.getArrayOfWritePointers(),
+					   firstChannel, numChannels);
+
+	splitLowBands(firstChannel, numChannels, numSamples, airBands);
+}
 
-	// Mix the buffers together and apply Dry/Wet for each channel
-	for (int channel = 0; channel < totalNumInputChannels; ++channel)
+void AirAudioProcessor::splitLowBands(int firstChannel, int numChannels, int numSamples, int airBands)
+{
+	// Split the air bands below the crossover off the low band, from the top down
+	for (int band = 1; band < airBands; ++band)
 	{
-		// Add lpBuffer to hpBuffer (after processing hpBuffer)
-		hpBuffer.addFrom(channel, 0, lpBuffer, channel, 0, numSamples);
+		float* const* bandChannels = bandBuffer.getArrayOfWritePointers() + (2 * band);
+
+		splits[band - 1]->process(numSamples, lpBuffer.getArrayOfWritePointers(), bandChannels,
+								  firstChannel, numChannels);
+	}
+}
+
+void AirAudioProcessor::prepareCrossover(double sampleRate)
+{
+	// Only run the design thread while the linear phase split is in use
+	if (crossoverMode == crossoverLinearPhase)
+		linearCrossover->prepare(sampleRate, *crossFreq);
+	else
+		linearCrossover->release();
+}
+
+int AirAudioProcessor::getCrossoverLatency()
+{
+	return crossoverMode == crossoverLinearPhase ? linearCrossover->getLatencySamples() : 0;
+}
+
+int AirAudioProcessor::getLatency()
+{
+	return getCrossoverLatency() + waveShaper->getLatencySamples();
+}
 
-		// WET GAIN
-		hpBuffer.applyGain(channel, 0, numSamples, *dryWet);
-		// DRY GAIN
-		buffer.applyGain(channel, 0, numSamples, 1.0 - *dryWet);
+void AirAudioProcessor::delayByOneSample(float* samples, int numSamples, float& last)
+{
+	if (numSamples <= 0)
+		return;
 
-		// Add wet signal to buffer
-		buffer.addFrom(channel, 0, hpBuffer, channel, 0, numSamples);
-    }
+	const float first = last;
+	last = samples[numSamples - 1];
 
+	memmove(samples + 1, samples, sizeof(float) * (size_t) (numSamples - 1));
+	samples[0] = first;
+}
+
+double AirAudioProcessor::getSplitFreq(int split, int bands)
+{
+	// Split 0 is the crossover, the rest are spaced evenly on a log scale down to the lowest split
+	if (split == 0)
+		return *crossFreq;
+
+	return *crossFreq * pow(lowestSplitFreq / *crossFreq, (double) split / (bands - 2));
+}
+
+void AirAudioProcessor::updateSplitFilters(int bands)
+{
+	// Only redesign the split filters whose frequency has moved
+	for (int split = 1; split < bands - 1; ++split)
+	{
+		const double newFreq = getSplitFreq(split, bands);
+
+		if (newFreq != splitFreq[split - 1])
+		{
+			Dsp::Params splitParams = filterParams;
+			splitParams[2] = newFreq;
+
+			redesign(*splits[split - 1], splitParams);
+			splitFreq[split - 1] = newFreq;
+		}
+	}
+}
+
+void AirAudioProcessor::redesign(CrossoverSplit& split, const Dsp::Params& newParams)
+{
+	if (isNonRealtime())
+		split.setParams(newParams);
+	else
+		split.requestParams(newParams);
 }
 
 //==============================================================================
@@ -281,6 +656,20 @@ void AirAudioProcessor::getStateInformation (MemoryBlock& destData)
 			xml.setAttribute(p->paramID, p->getValue());
 		}
 	}
+
+	// Store settings that aren't parameters
+	xml.setAttribute("crossoverMode", crossoverMode);
+	xml.setAttribute("crossoverFamily", crossoverFamily);
+	xml.setAttribute("crossoverOrder", crossoverOrder);
+	xml.setAttribute("detectorType", getDetectorType());
+	xml.setAttribute("shaperMode", getShaperMode());
+
+	for (int band = 0; band < maxAirBands; ++band)
+	{
+		xml.setAttribute("bandRatio" + String(band), bandRatioAmt[band]);
+		xml.setAttribute("bandSat" + String(band), bandSatAmt[band]);
+		xml.setAttribute("bandThresholdOffset" + String(band), bandThresholdOffset[band]);
+	}
 	
 	// Copy the XML to binary to be returned later
 	copyXmlToBinary(xml, destData);
@@ -308,6 +697,29 @@ void AirAudioProcessor::setStateInformation (const void* data, int sizeInBytes)
 					p->setValue((float)xmlState->getDoubleAttribute(p->paramID, p->getValue()));
 				}
 			}
+
+			setCrossoverMode(xmlState->getIntAttribute("crossoverMode", crossoverBessel));
+			setCrossoverFilters(jlimit(0, CrossoverFilters::numFamilies - 1, xmlState->getIntAttribute("crossoverFamily", CrossoverFilters::familyBessel)),
+								jlimit(CrossoverFilters::minOrder, CrossoverFilters::maxOrder, xmlState->getIntAttribute("crossoverOrder", 2)));
+			setDetectorType(jlimit((int) SideChain::detectorSamplePeak, (int) SideChain::detectorEnvelopeRms,
+								   xmlState->getIntAttribute("detectorType", SideChain::detectorSamplePeak)));
+			setShaperMode(jlimit(0, WaveShaper::numModes - 1, xmlState->getIntAttribute("shaperMode", WaveShaper::modeDirect)));
+
+			// Per-band amounts, keeping the current ones where the state has none, through the
+			// setters so that values out of range are clamped
+			for (int band = 0; band < maxAirBands; ++band)
+			{
+				setBandRatioAmt(band, xmlState->getDoubleAttribute("bandRatio" + String(band), bandRatioAmt[band]));
+				setBandSatAmt(band, xmlState->getDoubleAttribute("bandSat" + String(band), bandSatAmt[band]));
+				setBandThresholdOffset(band, xmlState->getDoubleAttribute("bandThresholdOffset" + String(band), bandThresholdOffset[band]));
+			}
+
+			// The release tail depends on the steepest ratio and lowest threshold
+			if (isPrepared)
+			{
+				const ScopedLock sl(getCallbackLock());
+				updateTailLength(getSampleRate());
+			}
 		}
 	}
 }
@@ -358,7 +770,7 @@ double AirAudioProcessor::getRatio()
 
 void AirAudioProcessor::updateRatio()
 {
-	cRatio = 1 + (airRatioAmt * *airAmt);
+	cRatio = 1 + (bandRatioAmt[0] * *airAmt);
 }
 
 double AirAudioProcessor::getHpGain()
@@ -393,12 +805,12 @@ void AirAudioProcessor::setSatAmt(double newSatAmt)
 
 double AirAudioProcessor::getAirRatioAmt()
 {
-	return airRatioAmt;
+	return bandRatioAmt[0];
 }
 
 void AirAudioProcessor::setAirRatioAmt(double newAirRatioAmt)
 {
-	airRatioAmt = newAirRatioAmt;
+	bandRatioAmt[0] = newAirRatioAmt;
 }
 
 double AirAudioProcessor::getAirGainAmt()
@@ -413,12 +825,12 @@ void AirAudioProcessor::setAirGainAmt(double newAirGainAmt)
 
 double AirAudioProcessor::getAirSatAmt()
 {
-	return airSatAmt;
+	return bandSatAmt[0];
 }
 
 void AirAudioProcessor::setAirSatAmt(double newAirSatAmt)
 {
-	airSatAmt = newAirSatAmt;
+	bandSatAmt[0] = newAirSatAmt;
 }
 
 double AirAudioProcessor::getAirAmt()
@@ -431,7 +843,185 @@ void AirAudioProcessor::setAirAmt(double newAirAmt)
 	*airAmt = newAirAmt;
 }
 
+double AirAudioProcessor::getBandRatioAmt(int band)
+{
+	jassert(band >= 0 && band < maxAirBands);
+	return bandRatioAmt[band];
+}
+
+void AirAudioProcessor::setBandRatioAmt(int band, double newRatioAmt)
+{
+	jassert(band >= 0 && band < maxAirBands);
+	bandRatioAmt[band] = jmax(0.0, newRatioAmt);
+}
+
+double AirAudioProcessor::getBandSatAmt(int band)
+{
+	jassert(band >= 0 && band < maxAirBands);
+	return bandSatAmt[band];
+}
+
+void AirAudioProcessor::setBandSatAmt(int band, double newSatAmt)
+{
+	jassert(band >= 0 && band < maxAirBands);
+	bandSatAmt[band] = jlimit(0.0, maxBandSatAmt, newSatAmt);
+}
+
+double AirAudioProcessor::getBandThresholdOffset(int band)
+{
+	jassert(band >= 0 && band < maxAirBands);
+	return bandThresholdOffset[band];
+}
+
+void AirAudioProcessor::setBandThresholdOffset(int band, double newOffset)
+{
+	jassert(band >= 0 && band < maxAirBands);
+	bandThresholdOffset[band] = jlimit(-maxBandThresholdOffset, maxBandThresholdOffset, newOffset);
+}
+
 double AirAudioProcessor::getTempGainReduction()
 {
 	return pCompressor->getTempGainReduction();
 }
+
+int AirAudioProcessor::getDetectorType()
+{
+	return pCompressor->getDetectorType();
+}
+
+void AirAudioProcessor::setDetectorType(int newDetectorType)
+{
+	// Hold off the audio callback while the side chains and envelope followers are rebuilt
+	const ScopedLock sl(getCallbackLock());
+
+	pCompressor->setDetectorType(newDetectorType);
+}
+
+int AirAudioProcessor::getShaperMode()
+{
+	return waveShaper->getMode();
+}
+
+void AirAudioProcessor::setShaperMode(int newMode)
+{
+	jassert(newMode >= 0 && newMode < WaveShaper::numModes);
+
+	if (newMode == waveShaper->getMode())
+		return;
+
+	{
+		// Hold off the audio callback, so that the air bands and the paths delayed to match
+		// them change over on the same sample
+		const ScopedLock sl(getCallbackLock());
+
+		waveShaper->setMode(newMode);
+
+		if (isPrepared)
+			reset();
+	}
+
+	// Tell the host outside the lock, as it may call back into the processor
+	setLatencySamples(getLatency());
+}
+
+int AirAudioProcessor::getCrossoverMode()
+{
+	return crossoverMode;
+}
+
+void AirAudioProcessor::setCrossoverMode(int newMode)
+{
+	jassert(newMode == crossoverBessel || newMode == crossoverLinearPhase);
+
+	if (newMode == crossoverMode)
+		return;
+
+	{
+		// Hold off the audio callback, as the linear phase split allocates when prepared
+		const ScopedLock sl(getCallbackLock());
+
+		crossoverMode = newMode;
+
+		if (isPrepared)
+		{
+			prepareCrossover(getSampleRate());
+			updateTailLength(getSampleRate());
+			reset();
+		}
+	}
+
+	// Tell the host outside the lock, as it may call back into the processor
+	setLatencySamples(getLatency());
+}
+
+int AirAudioProcessor::getCrossoverFamily()
+{
+	return crossoverFamily;
+}
+
+int AirAudioProcessor::getCrossoverOrder()
+{
+	return crossoverOrder;
+}
+
+void AirAudioProcessor::setCrossoverFilters(int newFamily, int newOrder)
+{
+	jassert(newFamily >= 0 && newFamily < CrossoverFilters::numFamilies);
+	jassert(newOrder >= CrossoverFilters::minOrder && newOrder <= CrossoverFilters::maxOrder);
+
+	if (newFamily == crossoverFamily && newOrder == crossoverOrder)
+		return;
+
+	// Create the filters of a new family before taking the lock, as that allocates
+	ScopedPointer<CrossoverSplit> newCrossover;
+	OwnedArray<CrossoverSplit> newSplits;
+
+	if (newFamily != crossoverFamily)
+	{
+		newCrossover = new CrossoverSplit(newFamily);
+
+		for (int split = 0; split < maxBands - 2; ++split)
+			newSplits.add(new CrossoverSplit(newFamily));
+	}
+
+	{
+		// Hold off the audio callback while the filters are swapped and redesigned
+		const ScopedLock sl(getCallbackLock());
+
+		if (newFamily != crossoverFamily)
+		{
+			// Take the old filters from the design thread, waiting for any design in progress
+			designService.removeClient(crossover);
+
+			for (CrossoverSplit* split : splits)
+				designService.removeClient(split);
+
+			crossover.swapWith(newCrossover);
+			splits.swapWith(newSplits);
+
+			designService.addClient(crossover);
+
+			for (CrossoverSplit* split : splits)
+				designService.addClient(split);
+		}
+
+		crossoverFamily = newFamily;
+		crossoverOrder = newOrder;
+
+		if (isPrepared)
+		{
+			designCrossoverFilters(getSampleRate());
+			updateTailLength(getSampleRate());
+			reset();
+		}
+	}
+
+	// The filters of the old family are deleted here, outside the lock
+}
+
+#if AIR_STAGE_PROFILING
+const StageProfiler& AirAudioProcessor::getStageProfiler() const
+{
+	return stageProfiler;
+}
+#endif
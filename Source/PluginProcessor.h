@@ -17,8 +17,16 @@ http://www.gnu.org/licenses/
 #define PLUGINPROCESSOR_H_INCLUDED
 
 #include "../JuceLibraryCode/JuceHeader.h"
+#include "AlignedBuffer.h"
 #include "Compressor.h"
-#include "DspFilters/dsp.h"
+#include "CrossoverFilters.h"
+#include "CrossoverSplit.h"
+#include "DspFilters/Dsp.h"
+#include "FilterDesignService.h"
+#include "LinearPhaseCrossover.h"
+#include "ParallelBranches.h"
+#include "RealtimeSafety.h"
+#include "StageProfiler.h"
 #include "WaveShaper.h"
 
 //==============================================================================
@@ -32,6 +40,7 @@ public:
     //==============================================================================
     void prepareToPlay (double sampleRate, int samplesPerBlock) override;
     void releaseResources() override;
+    void reset() override;
 
    #ifndef JucePlugin_PreferredChannelConfigurations
     bool setPreferredBusArrangement (bool isInput, int bus, const AudioChannelSet& preferredSet) override;
@@ -96,24 +105,132 @@ public:
 	double getAirAmt();
 	void setAirAmt(double newAirAmt);
 
+	// Per-band amounts for multiband mode, counting down from the air band (0), stored with the state.
+	// The setters clamp them to the range the processing supports.
+	double getBandRatioAmt(int band);
+	void setBandRatioAmt(int band, double newRatioAmt);
+
+	double getBandSatAmt(int band);
+	void setBandSatAmt(int band, double newSatAmt);
+
+	double getBandThresholdOffset(int band);
+	void setBandThresholdOffset(int band, double newOffset);
+
 	double getTempGainReduction();
 
+	// Compressor detector, one of SideChain::DetectorType (message thread only)
+	int getDetectorType();
+	void setDetectorType(int newDetectorType);
+
+	// Waveshaper antialiasing, one of WaveShaper::Mode (message thread only, changes the latency)
+	int getShaperMode();
+	void setShaperMode(int newMode);
+
+	// Crossover between the air band and the rest (message thread only, changes the latency)
+	enum CrossoverMode
+	{
+		crossoverBessel = 0,
+		crossoverLinearPhase
+	};
+
+	int getCrossoverMode();
+	void setCrossoverMode(int newMode);
+
+	// Family and order of the Bessel mode crossover and band splits, the family being one of
+	// CrossoverFilters::Family (message thread only)
+	int getCrossoverFamily();
+	int getCrossoverOrder();
+	void setCrossoverFilters(int newFamily, int newOrder);
+
+   #if AIR_STAGE_PROFILING
+	// Per-stage timings of processBlock, readable from any thread
+	const StageProfiler& getStageProfiler() const;
+   #endif
+
 	// Declare automatable parameters that host will understand
 	AudioParameterFloat* crossFreq;
 	AudioParameterFloat* dryWet;
 	AudioParameterFloat* cThreshold;
 	AudioParameterFloat* hpGain;
 	AudioParameterFloat* airAmt;
+	AudioParameterInt* numBands;
+
+	// Bands in multiband mode, the lowest of which is passed through untouched
+	static const int maxBands = 5;
+	static const int maxAirBands = maxBands - 1;
 
 private:
-	// Declare buffers
-	AudioSampleBuffer hpBuffer;
+	// Declare buffers (two channels per air band, the air band at the crossover first),
+	// referring to aligned scratch
+	AlignedBuffer bandStorage;
+	AlignedBuffer lpStorage;
+	AudioSampleBuffer bandBuffer;
 	AudioSampleBuffer lpBuffer;
 
-	// Declare filters
-	ScopedPointer<Dsp::Filter> lp;
-	ScopedPointer<Dsp::Filter> hp;
+	// Process part of a host block, at most one chunk long
+	void processChunk(AudioSampleBuffer& buffer, bool runInParallel);
+
+	// Samples processed at a time in realtime, with parameters read once per chunk
+	static const int internalChunkSize = 128;
+
+	// Declare crossover filters
+	ScopedPointer<CrossoverSplit> crossover;
 	Dsp::Params filterParams;
+	int crossoverFamily = CrossoverFilters::familyBessel;
+	int crossoverOrder = 2;
+
+	void designCrossoverFilters(double sampleRate);
+
+	// Declare filters splitting the low band further in multiband mode
+	OwnedArray<CrossoverSplit> splits;
+	double splitFreq[maxBands - 2];
+	int currentNumBands = 2;
+
+	// Lowest split frequency in multiband mode, the others being spaced evenly up to the crossover
+	const double lowestSplitFreq = 250.0;
+
+	double getSplitFreq(int split, int bands);
+	void updateSplitFilters(int bands);
+
+	// Declare the thread designing the crossover and splits as they move (after the filters,
+	// so that it stops before they are deleted)
+	FilterDesignService designService;
+
+	// Move a split to new parameters from the audio thread, designing it on the design thread
+	// in realtime and right away offline, so that renders stay reproducible
+	void redesign(CrossoverSplit& split, const Dsp::Params& newParams);
+
+	// Split a range of channels into bands, each channel independent of the others
+	void splitBands(int firstChannel, int numChannels, int numSamples, int airBands);
+	void splitLowBands(int firstChannel, int numChannels, int numSamples, int airBands);
+
+	// Declare linear phase crossover (prepared only while in use)
+	ScopedPointer<LinearPhaseCrossover> linearCrossover;
+	int crossoverMode = crossoverBessel;
+
+	void prepareCrossover(double sampleRate);
+	bool isPrepared = false;
+	int getCrossoverLatency();
+
+	// Latency of the crossover in use plus the waveshaper's delay, reported to the host
+	int getLatency();
+
+	// Declare silence detection
+	void updateTailLength(double sampleRate);
+
+	double tailLengthSeconds = 0.0;
+	int64 tailSamples = 0;
+	int64 silentSamples = 0;
+	bool isSleeping = false;
+
+	// Input level below which a block counts as silent (-120 dB)
+	const float silenceThreshold = 1.0e-6f;
+
+	// Declare worker pool for offline rendering (created on first use)
+	ScopedPointer<ParallelBranches> parallelBranches;
+
+	// Smallest offline block that is split over the worker pool
+	static const int minParallelBlockSize = 8192;
 
 	// Declare compressor
 	ScopedPointer<Compressor> pCompressor;
@@ -121,17 +238,38 @@ private:
 	// Declare waveshaper
 	ScopedPointer<WaveShaper> waveShaper;
 
+	// Last sample of each low band and dry channel, which delay them to match the waveshaper's
+	// antialiasing modes
+	float lpDelay[2] = { 0.0f, 0.0f };
+	float dryDelay[2] = { 0.0f, 0.0f };
+
+	// Delay a channel by one sample, carrying the last one over to the next chunk
+	static void delayByOneSample(float* samples, int numSamples, float& last);
+
 	// Declare parameters
 	double cRatio = 1.0;
 	double hpPreGain = 0;
 	double satAmt = 0.0;
 
-	double airRatioAmt = 3.0;
 	double airGainAmt = 0.0;
-	double airSatAmt = 0.5;
+
+	// Declare per-band amounts (band 0 holds the air ratio and saturation amounts)
+	double bandRatioAmt[maxAirBands] = { 3.0, 2.0, 1.0, 0.5 };
+	double bandSatAmt[maxAirBands] = { 0.5, 0.3, 0.15, 0.05 };
+	double bandThresholdOffset[maxAirBands] = { 0.0, 0.0, 0.0, 0.0 };
+
+	// The waveshaper's curve needs an amount below 1, and an offset can move a band's threshold
+	// by up to the width of the threshold range (the ratio amount only has to stay positive)
+	const double maxBandSatAmt = 0.99;
+	const double maxBandThresholdOffset = 40.0;
 
 	double tempRatio;
 
+   #if AIR_STAGE_PROFILING
+	// Declare stage profiler
+	StageProfiler stageProfiler;
+   #endif
+
 	// Declare program name
 	String defProgName = "Roth-AIR";
 
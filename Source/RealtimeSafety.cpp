@@ -0,0 +1,505 @@
+/*
+------------------------------------------------------------------------------
+
+Realtime safety checks
+================
+A diagnostic build mode for Roth-AIR that records any allocation, deallocation
+or mutex lock made by a thread while it is inside the audio callback.
+
+By Daniel Rothmann
+
+Provided under GNU General Public license:
+http://www.gnu.org/licenses/
+
+------------------------------------------------------------------------------
+*/
+
+#include "RealtimeSafety.h"
+
+#if AIR_REALTIME_CHECKS
+
+#include <atomic>
+#include <cstdlib>
+#include <new>
+
+#if JUCE_LINUX || JUCE_MAC
+ #include <execinfo.h>
+#endif
+
+#if JUCE_LINUX
+ #include <cerrno>
+ #include <dlfcn.h>
+ #include <pthread.h>
+
+// glibc's own allocator entry points, used to bypass the interposed versions below
+extern "C" void* __libc_malloc(size_t size);
+extern "C" void* __libc_calloc(size_t count, size_t size);
+extern "C" void* __libc_realloc(void* ptr, size_t size);
+extern "C" void* __libc_memalign(size_t alignment, size_t size);
+extern "C" void __libc_free(void* ptr);
+#endif
+
+namespace
+{
+	// Linked into an executable, as in the headless checker, these live in its static TLS
+	// block, so reading them never allocates
+	static thread_local bool insideAudioThread = false;
+	static thread_local bool isRecording = false;
+
+	RealtimeSafety::Violation violations[RealtimeSafety::maxViolations];
+	std::atomic<int> numViolations(0);
+
+	void* rawMalloc(size_t size)
+	{
+	   #if JUCE_LINUX
+		return __libc_malloc(size);
+	   #else
+		return std::malloc(size);
+	   #endif
+	}
+
+	void rawFree(void* ptr)
+	{
+	   #if JUCE_LINUX
+		__libc_free(ptr);
+	   #else
+		std::free(ptr);
+	   #endif
+	}
+
+   #if defined (__cpp_aligned_new)
+	// Only the aligned operator new replacements below need these
+	void* rawAlignedMalloc(size_t alignment, size_t size)
+	{
+	   #if JUCE_LINUX
+		return __libc_memalign(alignment, size);
+	   #elif JUCE_WINDOWS
+		return _aligned_malloc(size, alignment);
+	   #else
+		void* ptr = nullptr;
+		return posix_memalign(&ptr, jmax(alignment, sizeof(void*)), size) == 0 ? ptr : nullptr;
+	   #endif
+	}
+
+	void rawAlignedFree(void* ptr)
+	{
+	   #if JUCE_WINDOWS
+		_aligned_free(ptr);
+	   #else
+		rawFree(ptr);
+	   #endif
+	}
+   #endif
+
+	// backtrace() loads the unwinder on its first call, which allocates - do that up front
+	struct BacktracePrimer
+	{
+		BacktracePrimer()
+		{
+		   #if JUCE_LINUX || JUCE_MAC
+			void* frames[2];
+			backtrace(frames, 2);
+		   #endif
+		}
+	};
+
+	BacktracePrimer backtracePrimer;
+
+	const char* getViolationName(int type)
+	{
+		switch (type)
+		{
+			case RealtimeSafety::allocation:	return "allocation";
+			case RealtimeSafety::deallocation:	return "deallocation";
+			case RealtimeSafety::mutexLock:		return "mutex lock";
+			default:							return "unknown";
+		}
+	}
+}
+
+//==============================================================================
+RealtimeSafety::ScopedAudioThread::ScopedAudioThread()
+	: wasInside(insideAudioThread)
+{
+	insideAudioThread = true;
+}
+
+RealtimeSafety::ScopedAudioThread::~ScopedAudioThread()
+{
+	insideAudioThread = wasInside;
+}
+
+bool RealtimeSafety::isInsideAudioThread()
+{
+	return insideAudioThread;
+}
+
+void RealtimeSafety::reportCall(ViolationType type, size_t size)
+{
+	// Ignore calls off the audio thread and calls made while recording a violation
+	if (! insideAudioThread || isRecording)
+		return;
+
+	isRecording = true;
+
+	const int index = numViolations.fetch_add(1);
+
+	if (index < maxViolations)
+	{
+		Violation& violation = violations[index];
+		violation.type = type;
+		violation.size = size;
+
+	   #if JUCE_LINUX || JUCE_MAC
+		violation.numFrames = backtrace(violation.frames, maxStackFrames);
+	   #else
+		violation.numFrames = 0;
+	   #endif
+	}
+
+	isRecording = false;
+}
+
+int RealtimeSafety::getNumViolations()
+{
+	return numViolations.load();
+}
+
+void RealtimeSafety::clearViolations()
+{
+	numViolations.store(0);
+}
+
+String RealtimeSafety::getReport()
+{
+	const int total = numViolations.load();
+	const int numRecorded = jmin(total, maxViolations);
+
+	String report;
+
+	for (int i = 0; i < numRecorded; ++i)
+	{
+		const Violation& violation = violations[i];
+
+		report << "Realtime violation #" << (i + 1) << ": " << getViolationName(violation.type);
+
+		if (violation.type == allocation)
+			report << " (" << (int64) violation.size << " bytes)";
+
+		report << newLine;
+
+	   #if JUCE_LINUX || JUCE_MAC
+		// Skip the frames belonging to reportCall and the interposed function itself
+		if (char** symbols = backtrace_symbols(violation.frames, violation.numFrames))
+		{
+			for (int frame = 2; frame < violation.numFrames; ++frame)
+				report << "    " << symbols[frame] << newLine;
+
+			rawFree(symbols);
+		}
+	   #endif
+	}
+
+	if (total > numRecorded)
+		report << (total - numRecorded) << " further violations were not recorded" << newLine;
+
+	return report;
+}
+
+String RealtimeSafety::runAutomationMatrix(AudioProcessor& processor, double sampleRate)
+{
+	const int blockSizes[] = { 1, 17, 64, 256, 1024, 4096 };
+	const float gridValues[] = { 0.0f, 0.25f, 0.5f, 0.75f, 1.0f };
+	const int maxBlockSize = 4096;
+	const int numRandomBlocks = 64;
+
+	AudioBuffer<float> buffer(2, maxBlockSize);
+	MidiBuffer midiMessages;
+	Random random(0x41495221);
+
+	const Array<AudioProcessorParameter*>& parameters = processor.getParameters();
+
+	processor.setPlayConfigDetails(2, 2, sampleRate, maxBlockSize);
+	processor.prepareToPlay(sampleRate, maxBlockSize);
+
+	clearViolations();
+
+	for (int blockSize : blockSizes)
+	{
+		// Refer to the start of the preallocated buffer, so that nothing is allocated per block
+		AudioBuffer<float> block(buffer.getArrayOfWritePointers(), buffer.getNumChannels(), blockSize);
+
+		// Fill the block with noise and push it through the processor
+		auto processNoise = [&]()
+		{
+			for (int channel = 0; channel < block.getNumChannels(); ++channel)
+				for (int sample = 0; sample < blockSize; ++sample)
+					block.setSample(channel, sample, random.nextFloat() * 2.0f - 1.0f);
+
+			processor.processBlock(block, midiMessages);
+		};
+
+		// Step each parameter through the grid, one jump per block
+		for (AudioProcessorParameter* parameter : parameters)
+		{
+			const float defaultValue = parameter->getDefaultValue();
+
+			for (float value : gridValues)
+			{
+				parameter->setValue(value);
+				processNoise();
+			}
+
+			parameter->setValue(defaultValue);
+			processNoise();
+		}
+
+		// Then move all parameters at once to random positions
+		for (int i = 0; i < numRandomBlocks; ++i)
+		{
+			for (AudioProcessorParameter* parameter : parameters)
+				parameter->setValue(random.nextFloat());
+
+			processNoise();
+		}
+
+		for (AudioProcessorParameter* parameter : parameters)
+			parameter->setValue(parameter->getDefaultValue());
+	}
+
+	processor.releaseResources();
+
+	return getReport();
+}
+
+//==============================================================================
+// Interposed allocation functions
+
+void* operator new(size_t size)
+{
+	RealtimeSafety::reportCall(RealtimeSafety::allocation, size);
+
+	if (void* ptr = rawMalloc(size))
+		return ptr;
+
+	throw std::bad_alloc();
+}
+
+void* operator new[](size_t size)
+{
+	RealtimeSafety::reportCall(RealtimeSafety::allocation, size);
+
+	if (void* ptr = rawMalloc(size))
+		return ptr;
+
+	throw std::bad_alloc();
+}
+
+void* operator new(size_t size, const std::nothrow_t&) noexcept
+{
+	RealtimeSafety::reportCall(RealtimeSafety::allocation, size);
+	return rawMalloc(size);
+}
+
+void* operator new[](size_t size, const std::nothrow_t&) noexcept
+{
+	RealtimeSafety::reportCall(RealtimeSafety::allocation, size);
+	return rawMalloc(size);
+}
+
+void operator delete(void* ptr) noexcept
+{
+	if (ptr != nullptr)
+		RealtimeSafety::reportCall(RealtimeSafety::deallocation, 0);
+
+	rawFree(ptr);
+}
+
+void operator delete[](void* ptr) noexcept
+{
+	if (ptr != nullptr)
+		RealtimeSafety::reportCall(RealtimeSafety::deallocation, 0);
+
+	rawFree(ptr);
+}
+
+void operator delete(void* ptr, size_t) noexcept
+{
+	operator delete(ptr);
+}
+
+void operator delete[](void* ptr, size_t) noexcept
+{
+	operator delete[](ptr);
+}
+
+void operator delete(void* ptr, const std::nothrow_t&) noexcept
+{
+	operator delete(ptr);
+}
+
+void operator delete[](void* ptr, const std::nothrow_t&) noexcept
+{
+	operator delete[](ptr);
+}
+
+#if defined (__cpp_aligned_new)
+// Over-aligned types, which C++17 allocates through these
+void* operator new(size_t size, std::align_val_t alignment)
+{
+	RealtimeSafety::reportCall(RealtimeSafety::allocation, size);
+
+	if (void* ptr = rawAlignedMalloc((size_t) alignment, size))
+		return ptr;
+
+	throw std::bad_alloc();
+}
+
+void* operator new[](size_t size, std::align_val_t alignment)
+{
+	return operator new(size, alignment);
+}
+
+void* operator new(size_t size, std::align_val_t alignment, const std::nothrow_t&) noexcept
+{
+	RealtimeSafety::reportCall(RealtimeSafety::allocation, size);
+	return rawAlignedMalloc((size_t) alignment, size);
+}
+
+void* operator new[](size_t size, std::align_val_t alignment, const std::nothrow_t&) noexcept
+{
+	return operator new(size, alignment, std::nothrow);
+}
+
+void operator delete(void* ptr, std::align_val_t) noexcept
+{
+	if (ptr != nullptr)
+		RealtimeSafety::reportCall(RealtimeSafety::deallocation, 0);
+
+	rawAlignedFree(ptr);
+}
+
+void operator delete[](void* ptr, std::align_val_t alignment) noexcept
+{
+	operator delete(ptr, alignment);
+}
+
+void operator delete(void* ptr, size_t, std::align_val_t alignment) noexcept
+{
+	operator delete(ptr, alignment);
+}
+
+void operator delete[](void* ptr, size_t, std::align_val_t alignment) noexcept
+{
+	operator delete(ptr, alignment);
+}
+
+void operator delete(void* ptr, std::align_val_t alignment, const std::nothrow_t&) noexcept
+{
+	operator delete(ptr, alignment);
+}
+
+void operator delete[](void* ptr, std::align_val_t alignment, const std::nothrow_t&) noexcept
+{
+	operator delete(ptr, alignment);
+}
+#endif
+
+#if JUCE_LINUX
+//==============================================================================
+// Interposed libc functions (only effective when linked into the executable)
+
+namespace
+{
+	typedef int (*MutexFunction)(pthread_mutex_t*);
+
+	MutexFunction findMutexFunction(const char* name)
+	{
+		return (MutexFunction) dlsym(RTLD_NEXT, name);
+	}
+
+	// Resolved at static initialisation, so the lookup never happens on the audio thread
+	MutexFunction realMutexLock = findMutexFunction("pthread_mutex_lock");
+	MutexFunction realMutexTryLock = findMutexFunction("pthread_mutex_trylock");
+}
+
+extern "C"
+{
+	void* malloc(size_t size) noexcept
+	{
+		RealtimeSafety::reportCall(RealtimeSafety::allocation, size);
+		return __libc_malloc(size);
+	}
+
+	void* calloc(size_t count, size_t size) noexcept
+	{
+		RealtimeSafety::reportCall(RealtimeSafety::allocation, count * size);
+		return __libc_calloc(count, size);
+	}
+
+	void* realloc(void* ptr, size_t size) noexcept
+	{
+		RealtimeSafety::reportCall(RealtimeSafety::allocation, size);
+		return __libc_realloc(ptr, size);
+	}
+
+	void free(void* ptr) noexcept
+	{
+		if (ptr != nullptr)
+			RealtimeSafety::reportCall(RealtimeSafety::deallocation, 0);
+
+		__libc_free(ptr);
+	}
+
+	void* memalign(size_t alignment, size_t size) noexcept
+	{
+		RealtimeSafety::reportCall(RealtimeSafety::allocation, size);
+		return __libc_memalign(alignment, size);
+	}
+
+	void* aligned_alloc(size_t alignment, size_t size) noexcept
+	{
+		RealtimeSafety::reportCall(RealtimeSafety::allocation, size);
+		return __libc_memalign(alignment, size);
+	}
+
+	int posix_memalign(void** ptr, size_t alignment, size_t size) noexcept
+	{
+		RealtimeSafety::reportCall(RealtimeSafety::allocation, size);
+
+		// The alignment must be a power of two multiple of the size of a pointer
+		if (alignment % sizeof(void*) != 0 || (alignment & (alignment - 1)) != 0)
+			return EINVAL;
+
+		void* const allocated = __libc_memalign(alignment, size);
+
+		if (allocated == nullptr)
+			return ENOMEM;
+
+		*ptr = allocated;
+		return 0;
+	}
+
+	int pthread_mutex_lock(pthread_mutex_t* mutex) noexcept
+	{
+		RealtimeSafety::reportCall(RealtimeSafety::mutexLock, 0);
+
+		if (realMutexLock == nullptr)
+			realMutexLock = findMutexFunction("pthread_mutex_lock");
+
+		return realMutexLock(mutex);
+	}
+
+	int pthread_mutex_trylock(pthread_mutex_t* mutex) noexcept
+	{
+		RealtimeSafety::reportCall(RealtimeSafety::mutexLock, 0);
+
+		if (realMutexTryLock == nullptr)
+			realMutexTryLock = findMutexFunction("pthread_mutex_trylock");
+
+		return realMutexTryLock(mutex);
+	}
+}
+#endif
+
+#endif // AIR_REALTIME_CHECKS
@@ -0,0 +1,96 @@
+/*
+------------------------------------------------------------------------------
+
+Realtime safety checks
+================
+A diagnostic build mode for Roth-AIR that records any allocation, deallocation
+or mutex lock made by a thread while it is inside the audio callback.
+
+Enable it by building with AIR_REALTIME_CHECKS=1. Allocations made through
+operator new/delete, aligned ones included, are caught on every platform. On
+Linux, malloc/free, the aligned allocators and pthread mutexes are interposed
+as well - this only takes effect when the checks are linked into the
+executable, since symbols in a dlopen'ed plugin cannot override the ones the
+host already resolved. The AirRealtimeCheck target in CMakeLists.txt is such
+an executable.
+
+By Daniel Rothmann
+
+Provided under GNU General Public license:
+http://www.gnu.org/licenses/
+
+------------------------------------------------------------------------------
+*/
+
+#ifndef REALTIMESAFETY_H_INCLUDED
+#define REALTIMESAFETY_H_INCLUDED
+
+#include "../JuceLibraryCode/JuceHeader.h"
+
+#ifndef AIR_REALTIME_CHECKS
+ #define AIR_REALTIME_CHECKS 0
+#endif
+
+#if AIR_REALTIME_CHECKS
+ // Marks the rest of the enclosing scope as audio thread code
+ #define AIR_REALTIME_SECTION RealtimeSafety::ScopedAudioThread realtimeSection;
+#else
+ #define AIR_REALTIME_SECTION
+#endif
+
+namespace RealtimeSafety
+{
+	enum ViolationType
+	{
+		allocation,
+		deallocation,
+		mutexLock
+	};
+
+	// Number of stack frames kept for each violation
+	const int maxStackFrames = 16;
+
+	// Number of violations kept before further ones are only counted
+	const int maxViolations = 64;
+
+	struct Violation
+	{
+		int type;
+		size_t size;
+		int numFrames;
+		void* frames[maxStackFrames];
+	};
+
+	// Marks the calling thread as running audio code for the lifetime of the object
+	class ScopedAudioThread
+	{
+	public:
+		ScopedAudioThread();
+		~ScopedAudioThread();
+
+	private:
+		bool wasInside;
+
+		JUCE_DECLARE_NON_COPYABLE(ScopedAudioThread)
+	};
+
+	// Returns true if the calling thread is inside a ScopedAudioThread
+	bool isInsideAudioThread();
+
+	// Called by the interposed functions - records a violation if on the audio thread
+	void reportCall(ViolationType type, size_t size);
+
+	// Total number of violations since the last clearViolations()
+	int getNumViolations();
+	void clearViolations();
+
+	// Human readable list of the recorded violations with their stack snippets (not realtime safe)
+	String getReport();
+
+	// Runs the processor through every parameter at a grid of values, jumping between
+	// them mid-stream to simulate host automation, for a range of block sizes.
+	// Returns the violation report, which is empty when the audio path is clean.
+	String runAutomationMatrix(AudioProcessor& processor, double sampleRate);
+}
+
+#endif  // REALTIMESAFETY_H_INCLUDED
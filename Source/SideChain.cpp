@@ -11,6 +11,24 @@ https://github.com/mzuther/Squeezer
 
 #include "SideChain.h"
 
+// Polyphase coefficients of the ITU-R BS.1770-4 true peak interpolator, stored
+// tap by tap so that the four phases of a tap are adjacent and vectorize together
+const float SideChain::arrTruePeakCoefficients[SideChain::nTruePeakTaps][SideChain::nTruePeakPhases] =
+{
+	{  0.0017089843750f, -0.0291748046875f, -0.0189208984375f, -0.0083007812500f },
+	{  0.0109863281250f,  0.0292968750000f,  0.0330810546875f,  0.0148925781250f },
+	{ -0.0196533203125f, -0.0517578125000f, -0.0582275390625f, -0.0266113281250f },
+	{  0.0332031250000f,  0.0891113281250f,  0.1015625000000f,  0.0476074218750f },
+	{ -0.0594482421875f, -0.1665039062500f, -0.2003173828125f, -0.1022949218750f },
+	{  0.1373291015625f,  0.4650878906250f,  0.7797851562500f,  0.9721679687500f },
+	{  0.9721679687500f,  0.7797851562500f,  0.4650878906250f,  0.1373291015625f },
+	{ -0.1022949218750f, -0.2003173828125f, -0.1665039062500f, -0.0594482421875f },
+	{  0.0476074218750f,  0.1015625000000f,  0.0891113281250f,  0.0332031250000f },
+	{ -0.0266113281250f, -0.0582275390625f, -0.0517578125000f, -0.0196533203125f },
+	{  0.0148925781250f,  0.0330810546875f,  0.0292968750000f,  0.0109863281250f },
+	{ -0.0083007812500f, -0.0189208984375f, -0.0291748046875f,  0.0017089843750f }
+};
+
 SideChain::SideChain(int nSampleRate)
 {
 	// Convert sample rate to double
@@ -27,6 +45,9 @@ SideChain::SideChain(int nSampleRate)
 	setAttackRate(1);
 	setReleaseRate(60);
 
+	// Detect sample peaks by default
+	nDetectorType = detectorSamplePeak;
+
 	reset();
 }
 
@@ -40,10 +61,107 @@ return value: none
 */
 {
 	dGainReduction = 0.0;
+	dGainReductionIdeal = 0.0;
+	dGainReductionIntermediate = 0.0;
 	dGainCompensation = 0.0;
 	dDetectorOutputLevelSquared = 0.0;
 
 	dCrestFactorAutoGain = 20.0;
+
+	for (int nTap = 0; nTap < nTruePeakTaps - 1; ++nTap)
+		arrTruePeakHistory[nTap] = 0.0f;
+}
+
+int SideChain::getDetectorType()
+/* Get current detector type.
+
+	return value (int): returns current detector type (sample peak or true peak)*/
+{
+	return nDetectorType;
+}
+
+void SideChain::setDetectorType(int nDetectorTypeNew)
+/* Set new detector type.
+
+	nDetectorTypeNew (int): detectorSamplePeak to detect the level of the samples
+		themselves, detectorTruePeak to include peaks between samples,
+		detectorEnvelopePeak or detectorEnvelopeRms to take levels that have
+		already been smoothed by an envelope follower
+
+	return value: none*/
+{
+	jassert(nDetectorTypeNew >= detectorSamplePeak && nDetectorTypeNew <= detectorEnvelopeRms);
+
+	if (nDetectorTypeNew != nDetectorType)
+	{
+		nDetectorType = nDetectorTypeNew;
+
+		// Don't let old samples leak into the interpolator
+		for (int nTap = 0; nTap < nTruePeakTaps - 1; ++nTap)
+			arrTruePeakHistory[nTap] = 0.0f;
+	}
+}
+
+bool SideChain::isEnvelopeDetector()
+/* Check whether the detector takes its levels from an envelope follower.
+
+	return value (bool): true for detectorEnvelopePeak and detectorEnvelopeRms*/
+{
+	return nDetectorType == detectorEnvelopePeak || nDetectorType == detectorEnvelopeRms;
+}
+
+void SideChain::detectTruePeaks(const float* pfInput, float* pfPeaks, int nNumSamples)
+/* Calculate the true peak level of a block of samples, as the largest absolute
+	value of the sample itself and the points interpolated 4x after it. The
+	interpolator lags the input by about five samples.
+
+	pfInput (const float*): input samples
+	pfPeaks (float*): receives the absolute peak level for each input sample
+	nNumSamples (int): number of samples
+
+	return value: none*/
+{
+	const int nHistory = nTruePeakTaps - 1;
+
+	// Input preceded by the history, so every tap reads from one contiguous array
+	float arrWindow[nHistory + nTruePeakChunk];
+
+	for (int nStart = 0; nStart < nNumSamples; nStart += nTruePeakChunk)
+	{
+		const int nChunk = jmin(nTruePeakChunk, nNumSamples - nStart);
+
+		for (int i = 0; i < nHistory; ++i)
+			arrWindow[i] = arrTruePeakHistory[i];
+
+		for (int i = 0; i < nChunk; ++i)
+			arrWindow[nHistory + i] = pfInput[nStart + i];
+
+		for (int i = 0; i < nChunk; ++i)
+		{
+			const float* pfNewest = arrWindow + nHistory + i;
+
+			// One multiply-add per tap across all four phases
+			float arrPhases[nTruePeakPhases] = { 0.0f, 0.0f, 0.0f, 0.0f };
+
+			for (int nTap = 0; nTap < nTruePeakTaps; ++nTap)
+			{
+				const float fSample = pfNewest[-nTap];
+
+				for (int nPhase = 0; nPhase < nTruePeakPhases; ++nPhase)
+					arrPhases[nPhase] += arrTruePeakCoefficients[nTap][nPhase] * fSample;
+			}
+
+			float fPeak = fabsf(*pfNewest);
+
+			for (int nPhase = 0; nPhase < nTruePeakPhases; ++nPhase)
+				fPeak = jmax(fPeak, fabsf(arrPhases[nPhase]));
+
+			pfPeaks[nStart + i] = fPeak;
+		}
+
+		for (int i = 0; i < nHistory; ++i)
+			arrTruePeakHistory[i] = arrWindow[nChunk + i];
+	}
 }
 
 double SideChain::getDetectorRmsFilter()
@@ -215,6 +333,14 @@ void SideChain::processSample(double dInputLevel)
 	// Send input level to gain computer
 	dGainReductionIdeal = queryGainComputer(dInputLevel);
 
+	// Levels from an envelope follower are smooth already
+	if (isEnvelopeDetector())
+	{
+		dGainReductionIntermediate = dGainReductionIdeal;
+		dGainReduction = dGainReductionIdeal;
+		return;
+	}
+
 	// Filter calculated gain reductino through level detection filter
 	double dGainReductionNew = applyLevelDetectionFilter(dGainReductionIdeal);
 
@@ -222,6 +348,84 @@ void SideChain::processSample(double dInputLevel)
 	applyDetectorSmoothDecoupled(dGainReductionNew);
 }
 
+bool SideChain::isReleased(double dToleranceDb)
+/* Check whether the envelopes have released, so that no gain reduction is applied
+	beyond the tolerance.
+
+	dToleranceDb (double): largest remaining gain reduction (and detector level) in dB
+
+	return value (bool): true if the sidechain has released*/
+{
+	return dGainReduction <= dToleranceDb
+		&& dGainReductionIntermediate <= dToleranceDb
+		&& dDetectorOutputLevelSquared <= dToleranceDb * dToleranceDb;
+}
+
+void SideChain::skipReleasedSamples(int nNumSamples)
+/* Advance a released sidechain over samples that are all below the threshold.
+	The gain computer returns 0 for every one of them, so the envelopes simply
+	decay and can be stepped in closed form. This matches processSample up to
+	the released tolerance, since the detector output feeding the release
+	envelope stays below it.
+
+	nNumSamples (int): number of samples to skip
+
+	return value: none*/
+{
+	dGainReductionIdeal = 0.0;
+
+	// Without envelopes of its own, the gain reduction follows the gain computer
+	if (isEnvelopeDetector())
+	{
+		dGainReductionIntermediate = 0.0;
+		dGainReduction = 0.0;
+		return;
+	}
+
+	// RMS filter decays geometrically with no input
+	double dDetectorOutputLevel = 0.0;
+
+	if (dDetectorRateMs > 0.0)
+	{
+		dDetectorOutputLevelSquared *= pow(dDetectorCoefficient, nNumSamples);
+		dDetectorOutputLevel = sqrt(dDetectorOutputLevelSquared);
+	}
+
+	// Release envelope, including its peak detection
+	if (dReleaseCoefficient == 0.0)
+	{
+		dGainReductionIntermediate = dDetectorOutputLevel;
+	}
+	else
+	{
+		dGainReductionIntermediate *= pow(dReleaseCoefficient, nNumSamples);
+		dGainReductionIntermediate = jmax(dGainReductionIntermediate, dDetectorOutputLevel);
+	}
+
+	// Attack envelope
+	if (dAttackCoefficient == 0.0)
+	{
+		dGainReduction = dGainReductionIntermediate;
+	}
+	else
+	{
+		double dAttackDecay = pow(dAttackCoefficient, nNumSamples);
+		dGainReduction = (dAttackDecay * dGainReduction) + (1.0 - dAttackDecay) * dGainReductionIntermediate;
+	}
+
+	// Flush the decayed state before it turns denormal
+	const double dFlushLevel = 1e-30;
+
+	if (dDetectorOutputLevelSquared < dFlushLevel)
+		dDetectorOutputLevelSquared = 0.0;
+
+	if (dGainReductionIntermediate < dFlushLevel)
+		dGainReductionIntermediate = 0.0;
+
+	if (dGainReduction < dFlushLevel)
+		dGainReduction = 0.0;
+}
+
 double SideChain::applyLevelDetectionFilter(double dDetectorInputLevel)
 {
 	// Bypass RMS sensing if rate is <= 0
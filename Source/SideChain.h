@@ -17,11 +17,29 @@
 class SideChain
 {
 public:
+	// Declare detector types
+	enum DetectorType
+	{
+		detectorSamplePeak = 0,
+		detectorTruePeak,
+		detectorEnvelopePeak,
+		detectorEnvelopeRms
+	};
+
 	SideChain(int nSampleRate);
 	~SideChain();
 
 	void reset();
 
+	int getDetectorType();
+	void setDetectorType(int nDetectorTypeNew);
+
+	// True if the levels come from an envelope follower, which replaces the RMS filter
+	// and the attack and release envelopes of the sidechain
+	bool isEnvelopeDetector();
+
+	void detectTruePeaks(const float* pfInput, float* pfPeaks, int nNumSamples);
+
 	double getDetectorRmsFilter();
 	void setDetectorRmsFilter(double dDetectorRateMsNew);
 
@@ -41,6 +59,9 @@ public:
 
 	void processSample(double dSampleValue);
 
+	bool isReleased(double dToleranceDb);
+	void skipReleasedSamples(int nNumSamples);
+
 	static double lvltodb(double dLevel);
 	static double dbtolvl(double dDecibels);
     
@@ -61,6 +82,14 @@ private:
 	double dDetectorOutputLevelSquared;
 	double dDetectorRateMs;
 	int nDetectorType;
+
+	// True peak interpolator (4x oversampling, 12 taps per phase)
+	static const int nTruePeakPhases = 4;
+	static const int nTruePeakTaps = 12;
+	static const int nTruePeakChunk = 64;
+	static const float arrTruePeakCoefficients[nTruePeakTaps][nTruePeakPhases];
+
+	float arrTruePeakHistory[nTruePeakTaps - 1];
 	
 	double dThreshold;
 	double dRatioInternal;
@@ -0,0 +1,115 @@
+/*
+------------------------------------------------------------------------------
+
+Stage profiler
+================
+Optional per-stage timing of the Roth-AIR processing chain.
+
+By Daniel Rothmann
+
+Provided under GNU General Public license:
+http://www.gnu.org/licenses/
+
+------------------------------------------------------------------------------
+*/
+
+#include "StageProfiler.h"
+
+//====================================================
+
+StageProfiler::StageProfiler()
+{
+	reset();
+}
+
+void StageProfiler::addChunkTime(int stage, int64 nanoseconds)
+{
+	jassert(stage >= 0 && stage < numStages);
+
+	blockTime[stage] += nanoseconds;
+	hasRun[stage] = true;
+}
+
+void StageProfiler::endBlock()
+{
+	// Stages that didn't run this block, such as the shaper when it runs inside the
+	// compressor branches, are left out rather than recorded as taking no time
+	for (int stage = 0; stage < numStages; ++stage)
+	{
+		if (hasRun[stage])
+			addBlockTime(stage, blockTime[stage]);
+
+		blockTime[stage] = 0;
+		hasRun[stage] = false;
+	}
+}
+
+void StageProfiler::addBlockTime(int stage, int64 nanoseconds)
+{
+	jassert(stage >= 0 && stage < numStages);
+
+	// Only the audio thread writes, so a relaxed counter is enough to claim a slot
+	const int written = numWritten[stage].load(std::memory_order_relaxed);
+	history[stage][written % historySize].store(nanoseconds, std::memory_order_relaxed);
+	numWritten[stage].store(written + 1, std::memory_order_release);
+}
+
+StageProfiler::Stats StageProfiler::getStats(int stage) const
+{
+	jassert(stage >= 0 && stage < numStages);
+
+	Stats stats;
+
+	const int written = numWritten[stage].load(std::memory_order_acquire);
+	const int numBlocks = jmin(written, historySize);
+
+	if (numBlocks == 0)
+		return stats;
+
+	// Copy the window out, so sorting for the percentile doesn't touch the ring
+	int64 window[historySize];
+	int64 total = 0;
+
+	for (int i = 0; i < numBlocks; ++i)
+	{
+		window[i] = history[stage][i].load(std::memory_order_relaxed);
+		total += window[i];
+	}
+
+	std::sort(window, window + numBlocks);
+
+	const int p99Index = jmin(numBlocks - 1, (int) (0.99 * numBlocks));
+
+	stats.minMs = window[0] * 1.0e-6;
+	stats.meanMs = total * 1.0e-6 / numBlocks;
+	stats.p99Ms = window[p99Index] * 1.0e-6;
+	stats.numBlocks = numBlocks;
+
+	return stats;
+}
+
+void StageProfiler::reset()
+{
+	for (int stage = 0; stage < numStages; ++stage)
+	{
+		for (int i = 0; i < historySize; ++i)
+			history[stage][i].store(0);
+
+		numWritten[stage].store(0);
+
+		blockTime[stage] = 0;
+		hasRun[stage] = false;
+	}
+}
+
+const char* StageProfiler::getStageName(int stage)
+{
+	switch (stage)
+	{
+		case stageCrossover:	return "Crossover";
+		case stageWaveShaper:	return "WaveShaper";
+		case stageCompressor:	return "Compressor";
+		case stageMix:			return "Mix";
+		default:				return "";
+	}
+}
@@ -0,0 +1,137 @@
+/*
+------------------------------------------------------------------------------
+
+Stage profiler
+================
+Optional per-stage timing of the Roth-AIR processing chain.
+
+Build with AIR_STAGE_PROFILING=1 to time each stage of processBlock. A host
+block is processed in chunks, so each stage's time is added up over the
+chunks and recorded once per block. The audio
+thread only writes block durations into lock-free ring buffers; the editor
+overlay and headless tools read min/mean/p99 statistics from any thread.
+Durations are taken from std::chrono::steady_clock in nanoseconds, as stages
+often take less than the microsecond JUCE's high resolution ticks resolve.
+With profiling disabled the timer macro expands to nothing.
+
+By Daniel Rothmann
+
+Provided under GNU General Public license:
+http://www.gnu.org/licenses/
+
+------------------------------------------------------------------------------
+*/
+
+#ifndef STAGEPROFILER_H_INCLUDED
+#define STAGEPROFILER_H_INCLUDED
+
+#include "../JuceLibraryCode/JuceHeader.h"
+#include <atomic>
+#include <chrono>
+
+#ifndef AIR_STAGE_PROFILING
+ #define AIR_STAGE_PROFILING 0
+#endif
+
+#if AIR_STAGE_PROFILING
+ // Times the rest of the enclosing scope as part of the given stage's block time
+ #define AIR_PROFILE_STAGE(profiler, stage) StageProfiler::ScopedTimer JUCE_JOIN_MACRO(stageTimer, __LINE__) (profiler, stage);
+
+ // Records the stage times added up in the rest of the enclosing scope as one block
+ #define AIR_PROFILE_BLOCK(profiler) StageProfiler::ScopedBlock JUCE_JOIN_MACRO(stageBlock, __LINE__) (profiler);
+#else
+ #define AIR_PROFILE_STAGE(profiler, stage)
+ #define AIR_PROFILE_BLOCK(profiler)
+#endif
+
+class StageProfiler
+{
+public:
+	enum Stage
+	{
+		stageCrossover,
+		stageWaveShaper,
+		stageCompressor,
+		stageMix,
+		numStages
+	};
+
+	struct Stats
+	{
+		double minMs = 0.0;
+		double meanMs = 0.0;
+		double p99Ms = 0.0;
+		int numBlocks = 0;
+	};
+
+	// Times a scope and adds the duration to the given stage's current block
+	class ScopedTimer
+	{
+	public:
+		ScopedTimer(StageProfiler& owner, int stageIndex)
+			: profiler(owner), stage(stageIndex), start(Clock::now())
+		{
+		}
+
+		~ScopedTimer()
+		{
+			profiler.addChunkTime(stage, std::chrono::duration_cast<std::chrono::nanoseconds>(Clock::now() - start).count());
+		}
+
+	private:
+		typedef std::chrono::steady_clock Clock;
+
+		StageProfiler& profiler;
+		const int stage;
+		const Clock::time_point start;
+
+		JUCE_DECLARE_NON_COPYABLE(ScopedTimer)
+	};
+
+	// Ends the current block when leaving a scope
+	class ScopedBlock
+	{
+	public:
+		explicit ScopedBlock(StageProfiler& owner) : profiler(owner) {}
+		~ScopedBlock() { profiler.endBlock(); }
+
+	private:
+		StageProfiler& profiler;
+
+		JUCE_DECLARE_NON_COPYABLE(ScopedBlock)
+	};
+
+	StageProfiler();
+
+	// Add time spent in a stage to the current block (audio thread)
+	void addChunkTime(int stage, int64 nanoseconds);
+
+	// Store the time of every stage that ran in the current block and start the next (audio thread)
+	void endBlock();
+
+	// Store the duration of one block for a stage (audio thread, lock-free)
+	void addBlockTime(int stage, int64 nanoseconds);
+
+	// Statistics over the most recent blocks of a stage (any thread)
+	Stats getStats(int stage) const;
+
+	// Forget all recorded blocks
+	void reset();
+
+	static const char* getStageName(int stage);
+
+private:
+	// Number of blocks kept per stage
+	static const int historySize = 512;
+
+	std::atomic<int64> history[numStages][historySize];
+	std::atomic<int> numWritten[numStages];
+
+	// Time of each stage so far in the current block, only touched by the audio thread
+	int64 blockTime[numStages];
+	bool hasRun[numStages];
+
+	JUCE_DECLARE_NON_COPYABLE(StageProfiler)
+};
+
+#endif  // STAGEPROFILER_H_INCLUDED
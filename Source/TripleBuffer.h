@@ -0,0 +1,82 @@
+/*
+------------------------------------------------------------------------------
+
+Triple buffer
+================
+Hands the latest value of something from one thread to another without locks.
+
+The writer fills in its buffer and publishes it by swapping it with the
+middle one, and the reader takes the middle one by swapping it with its own.
+Neither side ever waits for the other or allocates, and the reader only ever
+sees whole values, the newest one published. Values published while the
+reader wasn't looking are simply skipped. There must be one writing thread
+and one reading thread at a time.
+
+By Daniel Rothmann
+
+Provided under GNU General Public license:
+http://www.gnu.org/licenses/
+
+------------------------------------------------------------------------------
+*/
+
+#ifndef TRIPLEBUFFER_H_INCLUDED
+#define TRIPLEBUFFER_H_INCLUDED
+
+#include "../JuceLibraryCode/JuceHeader.h"
+#include <atomic>
+
+template <typename Type>
+class TripleBuffer
+{
+public:
+	TripleBuffer()
+		: middle(1)
+	{
+	}
+
+	// The buffer for the writer to fill in, holding an older value
+	Type& getWriteBuffer()
+	{
+		return buffers[back];
+	}
+
+	// Hand the filled in buffer to the reader (writer only)
+	void publish()
+	{
+		back = middle.exchange(back | freshBit) & indexMask;
+	}
+
+	// Take the newest published value, returning false if there is none since the last one taken (reader only)
+	bool update()
+	{
+		if ((middle.load() & freshBit) == 0)
+			return false;
+
+		front = middle.exchange(front) & indexMask;
+		return true;
+	}
+
+	// The value last taken by update()
+	const Type& getReadBuffer() const
+	{
+		return buffers[front];
+	}
+
+private:
+	// The middle index carries a flag telling whether the writer left it there
+	enum
+	{
+		indexMask = 3,
+		freshBit = 4
+	};
+
+	Type buffers[3];
+	std::atomic<int> middle;
+	int front = 0;
+	int back = 2;
+
+	JUCE_DECLARE_NON_COPYABLE(TripleBuffer)
+};
+
+#endif  // TRIPLEBUFFER_H_INCLUDED
@@ -13,45 +13,264 @@ http://www.gnu.org/licenses/
 */
 
 #include "WaveShaper.h"
+#include "DspFilters/Dsp.h"
+
+//====================================================
+
+namespace
+{
+	// Differences of inputs below this are too small to divide by
+	const double tolerance = 1.0e-5;
+
+	// Below this value of k|x| the antiderivatives are summed as series, as their closed forms cancel
+	const double seriesLimit = 1.0e-2;
+
+	// Coefficient of the first order Thiran allpass that delays by half a sample, (1 - d) / (1 + d).
+	// It takes the first order mode to a whole sample, its phase delay exact at DC and 0.54 samples
+	// at 8 kHz, 0.61 at 12 kHz and 0.73 at 16 kHz (at 44.1 kHz).
+	const double halfSampleAllpass = 1.0 / 3.0;
+
+	// The curve at one amount k, with its first and second antiderivatives
+	struct Curve
+	{
+		Curve(double k)
+			: amount(k), gain(1.0 + k), scale1(gain / (k * k)), scale2(scale1 / k)
+		{
+		}
+
+		double shape(double x) const
+		{
+			return gain * x / (1.0 + amount * std::abs(x));
+		}
+
+		// (1 + k) / k^2 * (u - ln(1 + u)) with u = k|x|
+		double antiderivative1(double x) const
+		{
+			const double u = amount * std::abs(x);
+			const double g = (u < seriesLimit)
+				? u * u * (1.0 / 2 - u * (1.0 / 3 - u * (1.0 / 4 - u * (1.0 / 5 - u * (1.0 / 6 - u * (1.0 / 7 - u * (1.0 / 8 - u / 9)))))))
+				: u - std::log1p(u);
+
+			return scale1 * g;
+		}
+
+		// Odd, (1 + k) / k^3 * (u^2 / 2 + u - (1 + u) ln(1 + u)) for positive x
+		double antiderivative2(double x) const
+		{
+			const double u = amount * std::abs(x);
+			const double g = (u < seriesLimit)
+				? u * u * u * (1.0 / 6 - u * (1.0 / 12 - u * (1.0 / 20 - u * (1.0 / 30 - u * (1.0 / 42 - u * (1.0 / 56 - u / 72))))))
+				: u * u / 2 + u - (1.0 + u) * std::log1p(u);
+
+			return std::copysign(scale2 * g, x);
+		}
+
+		const double amount;
+		const double gain;
+		const double scale1;
+		const double scale2;
+	};
+}
 
 //====================================================
 
 WaveShaper::WaveShaper(int channels)
 {
-	amount = 0;
 	nChannels = channels;
+	amounts.insertMultiple(0, 0.0, nChannels);
+	histories.insertMultiple(0, History(), nChannels);
 }
 
 double WaveShaper::getAmount()
 {
-	return amount;
+	return amounts[0];
 }
 
 void WaveShaper::setAmount(double newAmount)
 {
-	amount = 2 * newAmount / (1 - newAmount);
+	for (int nChannel = 0; nChannel < nChannels; ++nChannel)
+		setAmount(nChannel, newAmount);
+}
+
+double WaveShaper::getAmount(int nChannel)
+{
+	return amounts[nChannel];
+}
+
+void WaveShaper::setAmount(int nChannel, double newAmount)
+{
+	jassert(nChannel >= 0 && nChannel < nChannels);
+
+	amounts.set(nChannel, 2 * newAmount / (1 - newAmount));
+}
+
+int WaveShaper::getMode()
+{
+	return mode;
+}
+
+void WaveShaper::setMode(int newMode)
+{
+	jassert(newMode >= 0 && newMode < numModes);
+
+	// Channels notice the change on their next block, so this is safe while processing
+	mode = newMode;
+}
+
+int WaveShaper::getLatencySamples()
+{
+	return mode == modeDirect ? 0 : 1;
+}
+
+void WaveShaper::reset()
+{
+	for (int nChannel = 0; nChannel < nChannels; ++nChannel)
+		histories.set(nChannel, History());
 }
 
 void WaveShaper::processBlock(AudioBuffer<float> &buffer)
 {
+	processChannels(buffer, 0, jmin(nChannels, buffer.getNumChannels()));
+}
+
+void WaveShaper::processChannels(AudioBuffer<float> &buffer, int startChannel, int numChannels)
+{
+	jassert(startChannel >= 0 && startChannel + numChannels <= jmin(nChannels, buffer.getNumChannels()));
+
 	int nNumSamples = buffer.getNumSamples();
+	const int currentMode = mode;
 
-	// Loop through samples
-	for (int nSample = 0; nSample < nNumSamples; ++nSample)
+	// Loop through channels
+	for (int nChannel = startChannel; nChannel < startChannel + numChannels; ++nChannel)
 	{
-		// Loop through channels
-		for (int nChannel = 0; nChannel < nChannels; ++nChannel)
+		const double amount = amounts[nChannel];
+		float* samples = buffer.getWritePointer(nChannel);
+		History& history = histories.getReference(nChannel);
+
+		// Start afresh in a new mode
+		if (history.mode != currentMode)
 		{
-			// Input sample (in)
-			float in = buffer.getSample(nChannel, nSample);
-			// Output sample (out)
-			float out = 0.0;
+			history = History();
+			history.mode = currentMode;
+		}
+
+		// A zero amount leaves the signal as it is but for the mode's delay, so skip the shaping,
+		// keeping up with the input
+		if (amount == 0.0)
+		{
+			if (nNumSamples > 0)
+			{
+				const double x1 = history.x1;
+				const double x2 = (nNumSamples > 1) ? samples[nNumSamples - 2] : history.x1;
+				history.x1 = samples[nNumSamples - 1];
+				history.x2 = x2;
+
+				if (currentMode != modeDirect)
+				{
+					memmove(samples + 1, samples, sizeof(float) * (size_t) (nNumSamples - 1));
+					samples[0] = (float) x1;
 
-			// Output sample becomes waveshaped in
-			out = (1.0 + amount) * in / (1.0 + amount * abs(in));
+					// Settle the allpass on the output, as though it had been running
+					history.allpassIn = history.allpassOut = samples[nNumSamples - 1];
+				}
+			}
 
-			// Change sample value in buffer
-			buffer.setSample(nChannel, nSample, out);
+			continue;
 		}
+
+		if (currentMode == modeAntiderivative1)
+			processAntiderivative1(samples, nNumSamples, amount, history);
+		else if (currentMode == modeAntiderivative2)
+			processAntiderivative2(samples, nNumSamples, amount, history);
+		else
+			Dsp::saturate(nNumSamples, samples, (float) amount);
 	}
 }
+
+void WaveShaper::processAntiderivative1(float* samples, int numSamples, double amount, History& history)
+{
+	const Curve curve(amount);
+
+	// The antiderivative depends on the amount, so the one of the last input is worked out again
+	double x1 = history.x1;
+	double x2 = history.x2;
+	double ad1 = curve.antiderivative1(x1);
+	double allpassIn = history.allpassIn;
+	double allpassOut = history.allpassOut;
+
+	for (int nSample = 0; nSample < numSamples; ++nSample)
+	{
+		const double x0 = samples[nSample];
+		const double ad0 = curve.antiderivative1(x0);
+
+		// The mean of the curve between the last two inputs, or its value halfway when they're too close to divide by
+		const double y = (std::abs(x0 - x1) < tolerance)
+			? curve.shape(0.5 * (x0 + x1))
+			: (ad0 - ad1) / (x0 - x1);
+
+		// Delay by the other half sample
+		allpassOut = halfSampleAllpass * (y - allpassOut) + allpassIn;
+		allpassIn = y;
+		samples[nSample] = (float) allpassOut;
+
+		x2 = x1;
+		x1 = x0;
+		ad1 = ad0;
+	}
+
+	history.x1 = x1;
+	history.x2 = x2;
+	history.allpassIn = allpassIn;
+	history.allpassOut = allpassOut;
+}
+
+void WaveShaper::processAntiderivative2(float* samples, int numSamples, double amount, History& history)
+{
+	const Curve curve(amount);
+
+	// Slope of the second antiderivative between two inputs, which is the mean of the first over them
+	auto meanOfAntiderivative1 = [&curve](double a, double b, double ad2a, double ad2b)
+	{
+		return (std::abs(a - b) < tolerance)
+			? curve.antiderivative1(0.5 * (a + b))
+			: (ad2a - ad2b) / (a - b);
+	};
+
+	double x1 = history.x1;
+	double x2 = history.x2;
+	double ad1 = curve.antiderivative2(x1);
+	double d1 = meanOfAntiderivative1(x1, x2, ad1, curve.antiderivative2(x2));
+
+	for (int nSample = 0; nSample < numSamples; ++nSample)
+	{
+		const double x0 = samples[nSample];
+		const double ad0 = curve.antiderivative2(x0);
+		const double d0 = meanOfAntiderivative1(x0, x1, ad0, ad1);
+		double y;
+
+		if (std::abs(x0 - x2) >= tolerance)
+		{
+			y = 2.0 * (d0 - d1) / (x0 - x2);
+		}
+		else
+		{
+			// The limit as the outer inputs meet, at their mean
+			const double xMean = 0.5 * (x0 + x2);
+			const double delta = xMean - x1;
+
+			y = (std::abs(delta) < tolerance)
+				? curve.shape(0.5 * (xMean + x1))
+				: 2.0 / delta * (curve.antiderivative1(xMean) + (ad1 - curve.antiderivative2(xMean)) / delta);
+		}
+
+		samples[nSample] = (float) y;
+
+		x2 = x1;
+		x1 = x0;
+		ad1 = ad0;
+		d1 = d0;
+	}
+
+	history.x1 = x1;
+	history.x2 = x2;
+}
@@ -20,16 +20,59 @@ http://www.gnu.org/licenses/
 class WaveShaper
 {
 public:
+	// How the curve is evaluated. The antiderivative modes suppress aliasing, delaying the
+	// signal by a sample (the first order one by half a sample, plus an allpass for the rest).
+	enum Mode
+	{
+		modeDirect = 0,
+		modeAntiderivative1,
+		modeAntiderivative2,
+		numModes
+	};
+
 	WaveShaper(int channels);
 
 	double getAmount();
 	void setAmount(double newAmount);
 
+	// Per-channel amount, for running several bands through one shaper
+	double getAmount(int nChannel);
+	void setAmount(int nChannel, double newAmount);
+
+	// Evaluation of the curve, one of Mode; each channel starts afresh in a new mode
+	int getMode();
+	void setMode(int newMode);
+
+	// Whole samples the current mode delays the signal by, which the other paths need to match
+	int getLatencySamples();
+
+	// Clear the input history of the antiderivative modes
+	void reset();
+
 	void processBlock(AudioBuffer<float> &buffer);
 
+	// Process a range of channels only; disjoint ranges may run on different threads
+	void processChannels(AudioBuffer<float> &buffer, int startChannel, int numChannels);
+
 private:
-	double amount;
+	// The last two inputs of a channel, the state of the half sample allpass, and the mode they
+	// were taken in
+	struct History
+	{
+		double x1 = 0.0;
+		double x2 = 0.0;
+		double allpassIn = 0.0;
+		double allpassOut = 0.0;
+		int mode = modeDirect;
+	};
+
+	static void processAntiderivative1(float* samples, int numSamples, double amount, History& history);
+	static void processAntiderivative2(float* samples, int numSamples, double amount, History& history);
+
+	Array<double> amounts;
+	Array<History> histories;
 	int nChannels;
+	std::atomic<int> mode { modeDirect };
 };
 
 
@@ -0,0 +1,639 @@
+/*
+------------------------------------------------------------------------------
+
+Benchmarks
+================
+Times the DSP building blocks of Roth-AIR and writes the results as a report.
+Each section is a table, and any of them can be run on its own.
+
+Usage: AirBenchmarks <report file> [section...]
+
+Build it in release; the timings of a debug build mean nothing.
+
+By Daniel Rothmann
+
+Provided under GNU General Public license:
+http://www.gnu.org/licenses/
+
+------------------------------------------------------------------------------
+*/
+
+#include "../Source/CrossoverSplit.h"
+#include "../Source/WaveShaper.h"
+#include <cstdio>
+#include <functional>
+#include <limits>
+#include <memory>
+#include <vector>
+
+namespace
+{
+	// Runs of each measurement, of which the fastest is kept as the least disturbed by the rest of the system
+	const int numRuns = 5;
+
+	// Block size of the measurements, a typical host size
+	const int blockSize = 512;
+
+	// Times process over numSamples samples in blocks, calling prepare untimed before each block.
+	// Returns nanoseconds per sample.
+	double measureNanoseconds(int numSamples, const std::function<void()>& prepare, const std::function<void()>& process)
+	{
+		int64 bestTicks = std::numeric_limits<int64>::max();
+
+		for (int run = 0; run < numRuns; ++run)
+		{
+			int64 ticks = 0;
+
+			for (int done = 0; done < numSamples; done += blockSize)
+			{
+				prepare();
+
+				const int64 start = Time::getHighResolutionTicks();
+				process();
+				ticks += Time::getHighResolutionTicks() - start;
+			}
+
+			bestTicks = jmin(bestTicks, ticks);
+		}
+
+		const int numBlocks = (numSamples + blockSize - 1) / blockSize;
+		return Time::highResolutionTicksToSeconds(bestTicks) * 1.0e9 / (numBlocks * blockSize);
+	}
+
+	void fillWithNoise(AudioSampleBuffer& buffer, Random& random)
+	{
+		for (int channel = 0; channel < buffer.getNumChannels(); ++channel)
+			for (int i = 0; i < buffer.getNumSamples(); ++i)
+				buffer.setSample(channel, i, random.nextFloat() * 2.0f - 1.0f);
+	}
+
+	//==============================================================================
+	// Crossover filters: a stereo split into both bands, for every family and order
+
+	double measureCrossover(int family, int order, double sampleRate, double freq)
+	{
+		CrossoverSplit split(family);
+		split.setParams(CrossoverFilters::getParams(split.getLowPass(), sampleRate, order, freq));
+
+		AudioSampleBuffer input(2, blockSize);
+		AudioSampleBuffer low(2, blockSize);
+		AudioSampleBuffer high(2, blockSize);
+		Random random(1);
+		fillWithNoise(input, random);
+
+		return measureNanoseconds((int) sampleRate,
+								  [&]() { low.makeCopyOf(input, true); },
+								  [&]() { split.process(blockSize, low.getArrayOfWritePointers(), high.getArrayOfWritePointers(), 0, 2); });
+	}
+
+	String benchmarkCrossovers()
+	{
+		const double sampleRate = 48000.0;
+		const double freq = 4000.0;
+
+		String report;
+		report << "Crossover cost, ns per stereo sample (low and high pass) at "
+			<< String(freq, 0) << " Hz, " << String(sampleRate, 0) << " Hz" << newLine;
+
+		report << String("").paddedRight(' ', 14);
+
+		for (int order = CrossoverFilters::minOrder; order <= CrossoverFilters::maxOrder; ++order)
+			report << ("order " + String(order)).paddedLeft(' ', 10);
+
+		report << newLine;
+
+		for (int family = 0; family < CrossoverFilters::numFamilies; ++family)
+		{
+			report << String(CrossoverFilters::getFamilyName(family)).paddedRight(' ', 14);
+
+			for (int order = CrossoverFilters::minOrder; order <= CrossoverFilters::maxOrder; ++order)
+				report << String(measureCrossover(family, order, sampleRate, freq), 2).paddedLeft(' ', 10);
+
+			report << newLine;
+		}
+
+		return report;
+	}
+
+	//==============================================================================
+	// Buffer utilities: every dispatched overload, and zero, once with each instruction set
+
+	// Calls per run when timing a single call
+	const int numCalls = 4096;
+
+	// Times a call that processes blockSize samples, returning nanoseconds per call
+	double measureCall(const std::function<void()>& call)
+	{
+		// Hosts flush denormals, and the in place kernels decay their buffers towards them
+		const ScopedNoDenormals noDenormals;
+
+		int64 bestTicks = std::numeric_limits<int64>::max();
+
+		for (int run = 0; run < numRuns; ++run)
+		{
+			const int64 start = Time::getHighResolutionTicks();
+
+			for (int i = 0; i < numCalls; ++i)
+				call();
+
+			bestTicks = jmin(bestTicks, Time::getHighResolutionTicks() - start);
+		}
+
+		return Time::highResolutionTicksToSeconds(bestTicks) * 1.0e9 / numCalls;
+	}
+
+	// The instruction sets this machine supports, in the order of the enum
+	Array<Dsp::CpuDispatch::InstructionSet> getSupportedSets()
+	{
+		Array<Dsp::CpuDispatch::InstructionSet> sets;
+
+		for (int set = 0; set < Dsp::CpuDispatch::numInstructionSets; ++set)
+			if (Dsp::CpuDispatch::isSupported((Dsp::CpuDispatch::InstructionSet) set))
+				sets.add((Dsp::CpuDispatch::InstructionSet) set);
+
+		return sets;
+	}
+
+	// Channels of noise, wide enough for the 8 channel interleaves
+	template <typename T>
+	struct Channels
+	{
+		Channels(int numChannels, int numSamples, Random& random)
+			: storage((size_t) (numChannels * numSamples))
+		{
+			for (T& sample : storage)
+				sample = (T) (random.nextFloat() * 2.0f - 1.0f);
+
+			for (int channel = 0; channel < numChannels; ++channel)
+				pointers.push_back(storage.data() + channel * numSamples);
+		}
+
+		T* operator[](int channel) { return pointers[(size_t) channel]; }
+		T* const* get() { return pointers.data(); }
+		const T* const* getConst() { return pointers.data(); }
+
+		std::vector<T> storage;
+		std::vector<T*> pointers;
+	};
+
+	String benchmarkUtilities()
+	{
+		const int maxChannels = 8;
+		Random random(1);
+
+		Channels<float> floatA(maxChannels, blockSize, random), floatB(maxChannels, blockSize, random);
+		Channels<double> doubleA(maxChannels, blockSize, random), doubleB(maxChannels, blockSize, random);
+		std::vector<float> floatInterleaved((size_t) (maxChannels * blockSize));
+		std::vector<double> doubleInterleaved((size_t) (maxChannels * blockSize));
+
+		struct Operation
+		{
+			const char* name;
+			std::function<void()> call;
+		};
+
+		const Operation operations[] =
+		{
+			{ "add float",             [&]() { Dsp::add(blockSize, floatA[0], floatB[0]); } },
+			{ "add double",            [&]() { Dsp::add(blockSize, doubleA[0], doubleB[0]); } },
+			{ "add double <- float",   [&]() { Dsp::add(blockSize, doubleA[0], floatB[0]); } },
+			{ "add float <- double",   [&]() { Dsp::add(blockSize, floatA[0], doubleB[0]); } },
+			{ "copy double <- float",  [&]() { Dsp::copy(blockSize, doubleA[0], floatB[0]); } },
+			{ "copy float <- double",  [&]() { Dsp::copy(blockSize, floatA[0], doubleB[0]); } },
+			{ "multiply float",        [&]() { Dsp::multiply(blockSize, floatA[0], -1.0f); } },
+			{ "multiply double",       [&]() { Dsp::multiply(blockSize, doubleA[0], -1.0); } },
+			{ "fade float",            [&]() { Dsp::fade(blockSize, floatA[0], 0.0f, 1.0f); } },
+			{ "fade double",           [&]() { Dsp::fade(blockSize, doubleA[0], 0.0, 1.0); } },
+			{ "cross fade float",      [&]() { Dsp::fade(blockSize, floatA[0], floatB[0], 0.0f, 1.0f); } },
+			{ "cross fade double",     [&]() { Dsp::fade(blockSize, doubleA[0], doubleB[0], 0.0, 1.0); } },
+			{ "interleave 2 float",    [&]() { Dsp::interleave(2, blockSize, floatInterleaved.data(), floatB.getConst()); } },
+			{ "interleave 2 double",   [&]() { Dsp::interleave(2, blockSize, doubleInterleaved.data(), doubleB.getConst()); } },
+			{ "interleave 8 float",    [&]() { Dsp::interleave(8, blockSize, floatInterleaved.data(), floatB.getConst()); } },
+			{ "interleave 8 double",   [&]() { Dsp::interleave(8, blockSize, doubleInterleaved.data(), doubleB.getConst()); } },
+			{ "deinterleave 2 float",  [&]() { Dsp::deinterleave(2, blockSize, floatA.get(), floatInterleaved.data()); } },
+			{ "deinterleave 2 double", [&]() { Dsp::deinterleave(2, blockSize, doubleA.get(), doubleInterleaved.data()); } },
+			{ "deinterleave 8 float",  [&]() { Dsp::deinterleave(8, blockSize, floatA.get(), floatInterleaved.data()); } },
+			{ "deinterleave 8 double", [&]() { Dsp::deinterleave(8, blockSize, doubleA.get(), doubleInterleaved.data()); } },
+			{ "reverse float",         [&]() { Dsp::reverse(blockSize, floatA[0], floatB[0]); } },
+			{ "reverse double",        [&]() { Dsp::reverse(blockSize, doubleA[0], doubleB[0]); } },
+			{ "to_mono float",         [&]() { Dsp::to_mono(blockSize, floatA[0], floatB[0], floatB[1]); } },
+			{ "to_mono double",        [&]() { Dsp::to_mono(blockSize, doubleA[0], doubleB[0], doubleB[1]); } },
+			{ "saturate float",        [&]() { Dsp::saturate(blockSize, floatA[0], 0.5f); } },
+			{ "zero float",            [&]() { Dsp::zero(blockSize, floatA[0]); } },
+			{ "zero double",           [&]() { Dsp::zero(blockSize, doubleA[0]); } }
+		};
+
+		const Array<Dsp::CpuDispatch::InstructionSet> sets = getSupportedSets();
+
+		String report;
+		report << "Buffer utilities, ns per " << blockSize << " samples with each instruction set "
+			<< "(generic is the reference templates; zero isn't dispatched)" << newLine;
+
+		report << String("").paddedRight(' ', 22);
+
+		for (Dsp::CpuDispatch::InstructionSet set : sets)
+			report << String(Dsp::CpuDispatch::getName(set)).paddedLeft(' ', 10);
+
+		report << newLine;
+
+		for (const Operation& operation : operations)
+		{
+			report << String(operation.name).paddedRight(' ', 22);
+
+			for (Dsp::CpuDispatch::InstructionSet set : sets)
+			{
+				Dsp::CpuDispatch::force(set);
+				Dsp::CpuDispatch::select();
+
+				report << String(measureCall(operation.call), 1).paddedLeft(' ', 10);
+			}
+
+			report << newLine;
+		}
+
+		Dsp::CpuDispatch::force(Dsp::CpuDispatch::numInstructionSets);
+		Dsp::CpuDispatch::select();
+
+		return report;
+	}
+
+	//==============================================================================
+	// Cascade forms: the same designs processed as a Cascade and in the other forms DSPFilters offers
+
+	// Sample rate and corner frequency of the cascade designs, those of the default crossover
+	const double cascadeSampleRate = 48000.0;
+	const double cascadeFreq = 4000.0;
+
+	// A design at the given order, with the family's own defaults for its shape
+	template <class Design>
+	struct CascadeDesign
+	{
+		CascadeDesign(int order)
+		{
+			// Through the base, which takes the defaults from the design's parameter info
+			Dsp::Params params = static_cast<const Dsp::Filter&>(filter).getDefaultParams();
+			params[0] = cascadeSampleRate;
+			params[1] = order;
+			params[2] = cascadeFreq;
+			filter.setParams(params);
+		}
+
+		const Dsp::Cascade& getCascade() const { return filter.getDesign(); }
+
+		Dsp::FilterDesign <Design> filter;
+	};
+
+	// Times a form that filters a block of one channel in place, returning nanoseconds per sample
+	double measureForm(const std::function<void(float*)>& process)
+	{
+		const ScopedNoDenormals noDenormals;
+
+		AudioSampleBuffer input(1, blockSize);
+		AudioSampleBuffer block(1, blockSize);
+		Random random(1);
+		fillWithNoise(input, random);
+
+		return measureNanoseconds((int) cascadeSampleRate,
+								  [&]() { block.makeCopyOf(input, true); },
+								  [&]() { process(block.getWritePointer(0)); });
+	}
+
+	double measureCascade(const Dsp::Cascade& cascade)
+	{
+		Dsp::CascadeStages <Dsp::BlockStateSpace::maxStages>::State <Dsp::DirectFormII> state;
+		return measureForm([&](float* samples) { cascade.process(blockSize, samples, state); });
+	}
+
+	String formatFormRow(const char* name, double cascadeNs, double formNs)
+	{
+		return String(name).paddedRight(' ', 30)
+			+ String(cascadeNs, 2).paddedLeft(' ', 10)
+			+ String(formNs, 2).paddedLeft(' ', 10)
+			+ (String(cascadeNs / formNs, 2) + "x").paddedLeft(' ', 10) + newLine;
+	}
+
+	String formatFormHeader(const String& title, const char* formName)
+	{
+		return title + newLine
+			+ String("").paddedRight(' ', 30)
+			+ String("cascade").paddedLeft(' ', 10)
+			+ String(formName).paddedLeft(' ', 10)
+			+ String("speedup").paddedLeft(' ', 10) + newLine;
+	}
+
+	template <class Design>
+	String measureStateSpace(const char* name, int order)
+	{
+		const CascadeDesign <Design> design(order);
+
+		Dsp::BlockStateSpace blockStateSpace;
+		blockStateSpace.setCascade(design.getCascade());
+		Dsp::BlockStateSpace::State state;
+
+		return formatFormRow(name, measureCascade(design.getCascade()),
+							 measureForm([&](float* samples) { blockStateSpace.process(blockSize, samples, state); }));
+	}
+
+	String benchmarkStateSpace()
+	{
+		String report = formatFormHeader("Block state space against a direct form II cascade, ns per sample, one channel at "
+										 + String(cascadeFreq, 0) + " Hz, " + String(cascadeSampleRate, 0) + " Hz", "block ss");
+
+		report << measureStateSpace <Dsp::Bessel::Design::LowPass<2>>("Bessel 2 low pass", 2)
+			<< measureStateSpace <Dsp::Bessel::Design::HighPass<2>>("Bessel 2 high pass", 2)
+			<< measureStateSpace <Dsp::Bessel::Design::LowPass<4>>("Bessel 4 low pass", 4)
+			<< measureStateSpace <Dsp::Butterworth::Design::LowPass<8>>("Butterworth 8 low pass", 8)
+			<< measureStateSpace <Dsp::Elliptic::Design::LowPass<7>>("Elliptic 7 low pass", 7);
+
+		return report;
+	}
+
+	template <class Design, int NumStages>
+	String measureFixedCascade(const char* name, int order)
+	{
+		const CascadeDesign <Design> design(order);
+
+		Dsp::FixedCascade <NumStages> fixedCascade;
+		fixedCascade.setCascade(design.getCascade());
+		typename Dsp::FixedCascade <NumStages>::State state;
+
+		return formatFormRow(name, measureCascade(design.getCascade()),
+							 measureForm([&](float* samples) { fixedCascade.process(blockSize, samples, state); }));
+	}
+
+	String benchmarkFixedCascade()
+	{
+		String report = formatFormHeader("Fixed cascade against a direct form II cascade, ns per sample, one channel at "
+										 + String(cascadeFreq, 0) + " Hz, " + String(cascadeSampleRate, 0) + " Hz", "fixed");
+
+		report << measureFixedCascade <Dsp::Bessel::Design::LowPass<2>, 1>("Bessel 2 low pass", 2)
+			<< measureFixedCascade <Dsp::Bessel::Design::LowPass<4>, 2>("Bessel 4 low pass", 4)
+			<< measureFixedCascade <Dsp::Butterworth::Design::LowPass<8>, 4>("Butterworth 8 low pass", 8)
+			<< measureFixedCascade <Dsp::Bessel::Design::LowPass<4>, 2>("Bessel 2 padded to 2 stages", 2);
+
+		return report;
+	}
+
+	//==============================================================================
+	// Waveshaper: cost and aliasing of every mode, against oversampling the direct curve
+
+	// The direct curve run at a multiple of the sample rate, between Chebyshev II low passes whose
+	// stop band starts at the original Nyquist
+	class Oversampler
+	{
+	public:
+		Oversampler(int newFactor, double sampleRate, int maxBlockSize)
+			: factor(newFactor), scratch(1, newFactor * maxBlockSize)
+		{
+			upFilter.setup(filterOrder, factor * sampleRate, 0.5 * sampleRate, stopBandDb);
+			downFilter.setup(filterOrder, factor * sampleRate, 0.5 * sampleRate, stopBandDb);
+		}
+
+		void process(float* samples, int numSamples, float amount)
+		{
+			float* upsampled = scratch.getWritePointer(0);
+			const int numUpsampled = numSamples * factor;
+
+			// Put zeros between the samples, scaled up to keep the level through the low pass
+			for (int i = 0; i < numSamples; ++i)
+			{
+				upsampled[i * factor] = factor * samples[i];
+
+				for (int j = 1; j < factor; ++j)
+					upsampled[i * factor + j] = 0.0f;
+			}
+
+			upFilter.process(numUpsampled, &upsampled);
+			Dsp::saturate(numUpsampled, upsampled, amount);
+			downFilter.process(numUpsampled, &upsampled);
+
+			for (int i = 0; i < numSamples; ++i)
+				samples[i] = upsampled[i * factor];
+		}
+
+	private:
+		static const int filterOrder = 12;
+		const double stopBandDb = 96.0;
+
+		int factor;
+		AudioSampleBuffer scratch;
+		Dsp::SimpleFilter<Dsp::ChebyshevII::LowPass<filterOrder>, 1> upFilter;
+		Dsp::SimpleFilter<Dsp::ChebyshevII::LowPass<filterOrder>, 1> downFilter;
+	};
+
+	typedef std::function<void(float* samples, int numSamples)> ShapingMethod;
+
+	// Time a way of shaping on noise, returning nanoseconds per sample
+	double measureShaping(const ShapingMethod& process, double sampleRate)
+	{
+		AudioSampleBuffer input(1, blockSize);
+		AudioSampleBuffer block(1, blockSize);
+		Random random(1);
+		fillWithNoise(input, random);
+
+		return measureNanoseconds((int) sampleRate,
+								  [&]() { block.makeCopyOf(input, true); },
+								  [&]() { process(block.getWritePointer(0), blockSize); });
+	}
+
+	// Shape a full scale sine, returning the power of everything but its harmonics relative
+	// to the harmonics in dB
+	double measureAliasing(const ShapingMethod& process, double sampleRate, double freq)
+	{
+		// Whole cycles over the measured length, at an odd bin of its spectrum, so that no
+		// alias of a harmonic lands on a harmonic below Nyquist
+		const int length = 16384;
+		const int settleLength = 4096;
+		int bin = roundToInt(freq * length / sampleRate);
+
+		if (bin % 2 == 0)
+			++bin;
+
+		HeapBlock<double> cosine(length);
+
+		for (int i = 0; i < length; ++i)
+			cosine[i] = cos(2.0 * MathConstants<double>::pi * i / length);
+
+		AudioSampleBuffer signal(1, settleLength + length);
+		float* samples = signal.getWritePointer(0);
+
+		for (int i = 0; i < settleLength + length; ++i)
+			samples[i] = (float) cosine[(int) (((int64) bin * i + 3 * length / 4) % length)];
+
+		for (int done = 0; done < signal.getNumSamples(); done += blockSize)
+			process(samples + done, jmin(blockSize, signal.getNumSamples() - done));
+
+		// Leave out the start, where the oversampling filters settle
+		const float* output = samples + settleLength;
+		double total = 0.0;
+
+		for (int i = 0; i < length; ++i)
+			total += (double) output[i] * output[i];
+
+		double harmonics = 0.0;
+
+		for (int harmonic = bin; harmonic < length / 2; harmonic += bin)
+		{
+			double re = 0.0;
+			double im = 0.0;
+
+			for (int i = 0; i < length; ++i)
+			{
+				const int64 phase = (int64) harmonic * i;
+				re += output[i] * cosine[(int) (phase % length)];
+				im += output[i] * cosine[(int) ((phase + 3 * length / 4) % length)];
+			}
+
+			harmonics += 2.0 * (re * re + im * im) / length;
+		}
+
+		return 10.0 * log10(jmax(total - harmonics, 1.0e-30 * total) / harmonics);
+	}
+
+	String benchmarkWaveShaper()
+	{
+		const double sampleRate = 48000.0;
+
+		// The strongest setting the plugin uses (k = 2)
+		const double amount = 0.5;
+		const double testFreqs[] = { 2000.0, 5000.0, 10000.0 };
+
+		String report;
+		report << "Waveshaper at amount " << String(amount, 2) << ", " << String(sampleRate, 0) << " Hz" << newLine
+			<< "Cost on full scale noise, aliasing of a full scale sine relative to its harmonics" << newLine;
+
+		report << String("").paddedRight(' ', 20) << String("ns/smp").paddedLeft(' ', 10);
+
+		for (double freq : testFreqs)
+			report << (String(freq / 1000.0, 0) + " kHz dB").paddedLeft(' ', 12);
+
+		report << newLine;
+
+		const int numMethods = WaveShaper::numModes + 3;
+
+		for (int method = 0; method < numMethods; ++method)
+		{
+			// The modes first, then oversampling by 2, 4 and 8
+			String name;
+			ShapingMethod process;
+			std::unique_ptr<WaveShaper> shaper;
+			std::unique_ptr<Oversampler> oversampler;
+
+			if (method < WaveShaper::numModes)
+			{
+				const char* const names[] = { "direct", "antiderivative 1", "antiderivative 2" };
+				name = names[method];
+			}
+			else
+			{
+				name = "oversampled " + String(2 << (method - WaveShaper::numModes)) + "x";
+			}
+
+			// Each measurement starts from a fresh state
+			auto create = [&]()
+			{
+				if (method < WaveShaper::numModes)
+				{
+					shaper.reset(new WaveShaper(1));
+					shaper->setAmount(amount);
+					shaper->setMode(method);
+
+					process = [&](float* samples, int numSamples)
+					{
+						float* channels[1] = { samples };
+						AudioSampleBuffer buffer(channels, 1, numSamples);
+						shaper->processBlock(buffer);
+					};
+				}
+				else
+				{
+					const float k = (float) (2 * amount / (1 - amount));
+					oversampler.reset(new Oversampler(2 << (method - WaveShaper::numModes), sampleRate, blockSize));
+
+					process = [&, k](float* samples, int numSamples)
+					{
+						oversampler->process(samples, numSamples, k);
+					};
+				}
+			};
+
+			create();
+			report << name.paddedRight(' ', 20) << String(measureShaping(process, sampleRate), 2).paddedLeft(' ', 10);
+
+			for (double freq : testFreqs)
+			{
+				create();
+				report << String(measureAliasing(process, sampleRate, freq), 1).paddedLeft(' ', 12);
+			}
+
+			report << newLine;
+		}
+
+		return report;
+	}
+
+	//==============================================================================
+	struct Section
+	{
+		const char* name;
+		std::function<String()> run;
+	};
+
+	std::vector<Section> createSections()
+	{
+		return
+		{
+			{ "crossovers",   benchmarkCrossovers },
+			{ "utilities",    benchmarkUtilities },
+			{ "statespace",   benchmarkStateSpace },
+			{ "fixedcascade", benchmarkFixedCascade },
+			{ "waveshaper",   benchmarkWaveShaper }
+		};
+	}
+}
+
+//==============================================================================
+int main(int argc, char* argv[])
+{
+	ScopedJuceInitialiser_GUI juceInitialiser;
+
+	const std::vector<Section> sections = createSections();
+
+	if (argc < 2)
+	{
+		printf("Usage: AirBenchmarks <report file> [section...]\nSections:");
+
+		for (const Section& section : sections)
+			printf(" %s", section.name);
+
+		printf("\n");
+		return 2;
+	}
+
+	const File reportFile = File::getCurrentWorkingDirectory().getChildFile(argv[1]);
+
+	StringArray chosen;
+
+	for (int i = 2; i < argc; ++i)
+		chosen.add(argv[i]);
+
+	String report;
+
+	for (const Section& section : sections)
+	{
+		if (chosen.size() > 0 && ! chosen.contains(section.name))
+			continue;
+
+		printf("Running %s\n", section.name);
+		report << section.run() << newLine;
+	}
+
+	if (! reportFile.replaceWithText(report))
+	{
+		printf("Can't write %s\n", reportFile.getFullPathName().toRawUTF8());
+		return 1;
+	}
+
+	printf("Wrote %s\n", reportFile.getFullPathName().toRawUTF8());
+	return 0;
+}
@@ -0,0 +1,228 @@
+/*
+------------------------------------------------------------------------------
+
+Compressor tests
+================
+Checks the Compressor's fast path for released chunks below threshold against
+the per-sample path it replaces. The same signal is compressed twice, once
+with the fast path and once with it disabled, and the gain applied to every
+sample must agree to within the compressor's released tolerance.
+
+The signal alternates bursts above threshold with long quiet stretches, so
+that the sidechain releases and the fast path takes over, and then re-crosses
+the threshold both inside a chunk and on a chunk boundary. The gain just after
+each re-crossing is checked on its own, since that is where the envelopes the
+fast path stepped in closed form are picked up by the per-sample path again.
+
+Usage: AirCompressorTests
+
+By Daniel Rothmann
+
+Provided under GNU General Public license:
+http://www.gnu.org/licenses/
+
+------------------------------------------------------------------------------
+*/
+
+#include "../Source/Compressor.h"
+#include <cmath>
+#include <cstdio>
+#include <vector>
+
+namespace
+{
+	const int sampleRate = 44100;
+	const int numChannels = 2;
+	const int hostBlockSize = 512;
+
+	// Compressor's internal chunk size, which the re-crossings are placed against
+	const int chunkSize = 64;
+
+	// Samples after each re-crossing that are checked on their own
+	const int recrossingLength = 4 * chunkSize;
+
+	const float loudLevel = 0.5f;
+	const float quietLevel = 0.001f;
+
+	//==============================================================================
+	// Test signal
+
+	struct Segment
+	{
+		int length;
+		float level;
+	};
+
+	// Bursts above threshold, each followed by long enough a stretch below it for
+	// the sidechain to release; the second and third bursts start inside a chunk
+	// and on a chunk boundary
+	const Segment segments[] =
+	{
+		{ 4410,    loudLevel },
+		{ 88200,   quietLevel },
+		{ 8837,    loudLevel },
+		{ 88200,   quietLevel },
+		{ 8800,    loudLevel },
+		{ 44100,   quietLevel }
+	};
+
+	std::vector<float> createSignal(int channel, std::vector<int>& recrossings)
+	{
+		std::vector<float> signal;
+		recrossings.clear();
+
+		for (const Segment& segment : segments)
+		{
+			if (segment.level == loudLevel && ! signal.empty())
+				recrossings.push_back((int) signal.size());
+
+			for (int i = 0; i < segment.length; ++i)
+			{
+				const double phase = 2.0 * double_Pi * (220.0 + 110.0 * channel) * (double) signal.size() / sampleRate;
+				signal.push_back(segment.level * (float) std::sin(phase));
+			}
+		}
+
+		return signal;
+	}
+
+	//==============================================================================
+	// Settings to compare the paths at
+
+	struct Case
+	{
+		const char* name;
+		int detectorType;
+		double rmsFilterMs;
+		int attackMs;
+		int releaseMs;
+	};
+
+	const Case cases[] =
+	{
+		{ "sample peak",           SideChain::detectorSamplePeak,   0.0,  10, 100 },
+		{ "sample peak, RMS",      SideChain::detectorSamplePeak,   10.0, 10, 100 },
+		{ "sample peak, fast",     SideChain::detectorSamplePeak,   0.0,  0,  20 },
+		{ "true peak",             SideChain::detectorTruePeak,     0.0,  10, 100 },
+		{ "envelope peak",         SideChain::detectorEnvelopePeak, 0.0,  10, 100 },
+		{ "envelope RMS",          SideChain::detectorEnvelopeRms,  0.0,  10, 100 }
+	};
+
+	// Compress the signals in host blocks. Also returns the remaining gain reduction
+	// of the first channel at the end of each quiet stretch.
+	std::vector<std::vector<float>> render(const Case& testCase, bool useFastPath,
+		const std::vector<std::vector<float>>& inputs, std::vector<double>& releasedGainReductions)
+	{
+		Compressor compressor(numChannels, sampleRate);
+		compressor.setDetectorType(testCase.detectorType);
+		compressor.setDetectorRmsFilter(testCase.rmsFilterMs);
+		compressor.setAttackRate(testCase.attackMs);
+		compressor.setReleaseRate(testCase.releaseMs);
+		compressor.setThreshold(-20.0);
+		compressor.setRatio(4.0);
+		compressor.setMakeupGain(0.0);
+		compressor.setReleasedFastPathEnabled(useFastPath);
+		compressor.resetSideChain();
+
+		std::vector<std::vector<float>> outputs = inputs;
+		const int numSamples = (int) inputs[0].size();
+
+		std::vector<int> quietEnds;
+		int segmentEnd = 0;
+
+		for (const Segment& segment : segments)
+		{
+			segmentEnd += segment.length;
+
+			if (segment.level == quietLevel)
+				quietEnds.push_back(segmentEnd);
+		}
+
+		releasedGainReductions.clear();
+		AudioBuffer<float> buffer(numChannels, hostBlockSize);
+
+		for (int start = 0; start < numSamples; start += hostBlockSize)
+		{
+			const int blockSize = jmin(hostBlockSize, numSamples - start);
+			buffer.setSize(numChannels, blockSize, false, false, true);
+
+			for (int channel = 0; channel < numChannels; ++channel)
+				buffer.copyFrom(channel, 0, outputs[channel].data() + start, blockSize);
+
+			compressor.processBlock(buffer);
+
+			for (int channel = 0; channel < numChannels; ++channel)
+				FloatVectorOperations::copy(outputs[channel].data() + start, buffer.getReadPointer(channel), blockSize);
+
+			// Quiet stretches end on block boundaries only by chance, so look at the last
+			// block that ends inside each one
+			for (int quietEnd : quietEnds)
+				if (start + blockSize <= quietEnd && start + 2 * blockSize > quietEnd)
+					releasedGainReductions.push_back(compressor.getTempGainReduction());
+		}
+
+		return outputs;
+	}
+
+	// Difference between the gains the two renders applied to one sample, in dB
+	double getGainDifference(float input, float fastOutput, float exactOutput)
+	{
+		if (input == 0.0f)
+			return 0.0;
+
+		return std::abs(20.0 * std::log10((double) fastOutput / (double) exactOutput));
+	}
+}
+
+//==============================================================================
+int main()
+{
+	int numFailures = 0;
+
+	std::vector<std::vector<float>> inputs;
+	std::vector<int> recrossings;
+
+	for (int channel = 0; channel < numChannels; ++channel)
+		inputs.push_back(createSignal(channel, recrossings));
+
+	const double tolerance = Compressor(numChannels, sampleRate).getReleasedTolerance();
+
+	for (const Case& testCase : cases)
+	{
+		std::vector<double> fastReleased;
+		std::vector<double> exactReleased;
+		const std::vector<std::vector<float>> fastOutputs = render(testCase, true, inputs, fastReleased);
+		const std::vector<std::vector<float>> exactOutputs = render(testCase, false, inputs, exactReleased);
+
+		double maxDifference = 0.0;
+		double maxRecrossingDifference = 0.0;
+
+		for (int channel = 0; channel < numChannels; ++channel)
+		{
+			for (int i = 0; i < (int) inputs[channel].size(); ++i)
+				maxDifference = jmax(maxDifference, getGainDifference(inputs[channel][i], fastOutputs[channel][i], exactOutputs[channel][i]));
+
+			for (int recrossing : recrossings)
+				for (int i = recrossing; i < recrossing + recrossingLength; ++i)
+					maxRecrossingDifference = jmax(maxRecrossingDifference, getGainDifference(inputs[channel][i], fastOutputs[channel][i], exactOutputs[channel][i]));
+		}
+
+		// Unless the per-sample path releases in every quiet stretch, the fast path is never taken
+		bool hasReleased = ! exactReleased.empty();
+
+		for (double gainReduction : exactReleased)
+			hasReleased = hasReleased && gainReduction <= tolerance;
+
+		const bool passed = hasReleased && maxDifference <= tolerance && maxRecrossingDifference <= tolerance;
+
+		printf("%s %s: gain difference %.3g dB, %.3g dB after re-crossing (allowed %.3g dB)%s\n",
+			passed ? "pass" : "FAIL", testCase.name, maxDifference, maxRecrossingDifference, tolerance,
+			hasReleased ? "" : ", never released");
+
+		if (! passed)
+			++numFailures;
+	}
+
+	printf("%d failures\n", numFailures);
+	return numFailures == 0 ? 0 : 1;
+}
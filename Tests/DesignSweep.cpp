@@ -0,0 +1,52 @@
+/*
+------------------------------------------------------------------------------
+
+Filter design sweep tool
+================
+Runs FilterDesignSweep over every DSPFilters design and writes its report.
+
+Usage: AirDesignSweep <report file> [fuzz points per design] [setup budget in us]
+
+By Daniel Rothmann
+
+Provided under GNU General Public license:
+http://www.gnu.org/licenses/
+
+------------------------------------------------------------------------------
+*/
+
+#include "FilterDesignSweep.h"
+#include <cstdio>
+
+namespace
+{
+	const int defaultFuzzPoints = 200;
+	const double defaultSetupBudgetMicroseconds = 20.0;
+}
+
+//==============================================================================
+int main(int argc, char* argv[])
+{
+	ScopedJuceInitialiser_GUI juceInitialiser;
+
+	if (argc < 2)
+	{
+		printf("Usage: AirDesignSweep <report file> [fuzz points per design] [setup budget in us]\n");
+		return 2;
+	}
+
+	const File reportFile = File::getCurrentWorkingDirectory().getChildFile(argv[1]);
+	const int fuzzPoints = argc > 2 ? String(argv[2]).getIntValue() : defaultFuzzPoints;
+	const double setupBudget = argc > 3 ? String(argv[3]).getDoubleValue() : defaultSetupBudgetMicroseconds;
+
+	const String report = FilterDesignSweep::runSweep(fuzzPoints, setupBudget);
+
+	if (! reportFile.replaceWithText(report))
+	{
+		printf("Can't write %s\n", reportFile.getFullPathName().toRawUTF8());
+		return 1;
+	}
+
+	printf("Wrote %s\n", reportFile.getFullPathName().toRawUTF8());
+	return 0;
+}
@@ -0,0 +1,459 @@
+/*
+------------------------------------------------------------------------------
+
+Filter design sweep
+================
+Setup cost, throughput and robustness of every DSPFilters design.
+
+By Daniel Rothmann
+
+Provided under GNU General Public license:
+http://www.gnu.org/licenses/
+
+------------------------------------------------------------------------------
+*/
+
+#include "FilterDesignSweep.h"
+
+#include <algorithm>
+#include <chrono>
+#include <stdexcept>
+
+//====================================================
+
+namespace
+{
+	using FilterDesignSweep::maxOrder;
+
+	template <class Design>
+	Dsp::Filter* create()
+	{
+		return new Dsp::FilterDesign <Design, 1>();
+	}
+
+	// Every design of the library, each a factory function filled in at compile time
+	Dsp::Filter* (*const designs[])() =
+	{
+		create <Dsp::Bessel::Design::LowPass<maxOrder>>,
+		create <Dsp::Bessel::Design::HighPass<maxOrder>>,
+		create <Dsp::Bessel::Design::BandPass<maxOrder>>,
+		create <Dsp::Bessel::Design::BandStop<maxOrder>>,
+		create <Dsp::Bessel::Design::LowShelf<maxOrder>>,
+
+		create <Dsp::Butterworth::Design::LowPass<maxOrder>>,
+		create <Dsp::Butterworth::Design::HighPass<maxOrder>>,
+		create <Dsp::Butterworth::Design::BandPass<maxOrder>>,
+		create <Dsp::Butterworth::Design::BandStop<maxOrder>>,
+		create <Dsp::Butterworth::Design::LowShelf<maxOrder>>,
+		create <Dsp::Butterworth::Design::HighShelf<maxOrder>>,
+		create <Dsp::Butterworth::Design::BandShelf<maxOrder>>,
+
+		create <Dsp::ChebyshevI::Design::LowPass<maxOrder>>,
+		create <Dsp::ChebyshevI::Design::HighPass<maxOrder>>,
+		create <Dsp::ChebyshevI::Design::BandPass<maxOrder>>,
+		create <Dsp::ChebyshevI::Design::BandStop<maxOrder>>,
+		create <Dsp::ChebyshevI::Design::LowShelf<maxOrder>>,
+		create <Dsp::ChebyshevI::Design::HighShelf<maxOrder>>,
+		create <Dsp::ChebyshevI::Design::BandShelf<maxOrder>>,
+
+		create <Dsp::ChebyshevII::Design::LowPass<maxOrder>>,
+		create <Dsp::ChebyshevII::Design::HighPass<maxOrder>>,
+		create <Dsp::ChebyshevII::Design::BandPass<maxOrder>>,
+		create <Dsp::ChebyshevII::Design::BandStop<maxOrder>>,
+		create <Dsp::ChebyshevII::Design::LowShelf<maxOrder>>,
+		create <Dsp::ChebyshevII::Design::HighShelf<maxOrder>>,
+		create <Dsp::ChebyshevII::Design::BandShelf<maxOrder>>,
+
+		create <Dsp::Elliptic::Design::LowPass<maxOrder>>,
+		create <Dsp::Elliptic::Design::HighPass<maxOrder>>,
+		create <Dsp::Elliptic::Design::BandPass<maxOrder>>,
+		create <Dsp::Elliptic::Design::BandStop<maxOrder>>,
+
+		create <Dsp::Legendre::Design::LowPass<maxOrder>>,
+		create <Dsp::Legendre::Design::HighPass<maxOrder>>,
+		create <Dsp::Legendre::Design::BandPass<maxOrder>>,
+		create <Dsp::Legendre::Design::BandStop<maxOrder>>,
+
+		create <Dsp::RBJ::Design::LowPass>,
+		create <Dsp::RBJ::Design::HighPass>,
+		create <Dsp::RBJ::Design::BandPass1>,
+		create <Dsp::RBJ::Design::BandPass2>,
+		create <Dsp::RBJ::Design::BandStop>,
+		create <Dsp::RBJ::Design::LowShelf>,
+		create <Dsp::RBJ::Design::HighShelf>,
+		create <Dsp::RBJ::Design::BandShelf>,
+		create <Dsp::RBJ::Design::AllPass>,
+
+		create <Dsp::StateVariable::Design::LowPass>,
+		create <Dsp::StateVariable::Design::HighPass>,
+		create <Dsp::StateVariable::Design::BandPass>,
+
+		create <Dsp::Custom::Design::OnePole>,
+		create <Dsp::Custom::Design::TwoPole>
+	};
+
+	const char* const outcomeNames[FilterDesignSweep::numOutcomes] =
+	{
+		"ok", "marginal", "unstable", "NaN", "blow up", "threw"
+	};
+
+	const double sweepSampleRates[] = { 44100.0, 48000.0, 96000.0, 192000.0 };
+	const int numSweepSampleRates = numElementsInArray(sweepSampleRates);
+
+	// Steps across the range of each continuous parameter
+	const int sweepSteps = 16;
+
+	// Noise run through each design, and the peak level above which its output counts as blown up
+	const int probeLength = 1024;
+	const double blowUpLevel = 1.0e4;
+
+	bool isFinite(const Dsp::complex_t& c)
+	{
+		return std::isfinite(c.real()) && std::isfinite(c.imag());
+	}
+
+	int findParam(const Dsp::Filter& filter, Dsp::ParamID id)
+	{
+		for (int i = 0; i < filter.getNumParams(); ++i)
+			if (filter.getParamInfo(i).getId() == id)
+				return i;
+
+		return -1;
+	}
+
+	String describeParams(const Dsp::Filter& filter, const Dsp::Params& params)
+	{
+		String text;
+
+		for (int i = 0; i < filter.getNumParams(); ++i)
+		{
+			const Dsp::ParamInfo info = filter.getParamInfo(i);
+			text << (i > 0 ? ", " : "") << info.getLabel() << " " << String(info.toString(params[i]));
+		}
+
+		return text;
+	}
+
+	typedef std::chrono::steady_clock Clock;
+
+	double getSecondsSince(Clock::time_point start)
+	{
+		return std::chrono::duration<double>(Clock::now() - start).count();
+	}
+
+	// Designs that throw are counted by checkDesign, here they only take their time
+	void setParamsIgnoringErrors(Dsp::Filter& filter, const Dsp::Params& params)
+	{
+		try
+		{
+			filter.setParams(params);
+		}
+		catch (const std::exception&)
+		{
+		}
+	}
+
+	// Results of one design over the whole sweep
+	struct DesignStats
+	{
+		int points = 0;
+		Array<double> coldSetupSeconds;
+		Array<double> cachedSetupSeconds;
+		int outcomes[FilterDesignSweep::numOutcomes] = {};
+
+		// First point of each failing outcome
+		String firstFailure[FilterDesignSweep::numOutcomes];
+
+		void add(int design, Dsp::Filter& filter, const Dsp::Params& params)
+		{
+			const FilterDesignSweep::Outcome outcome = FilterDesignSweep::checkDesign(filter, params);
+
+			++points;
+			coldSetupSeconds.add(FilterDesignSweep::measureSetup(design, params, true));
+			cachedSetupSeconds.add(FilterDesignSweep::measureSetup(design, params, false));
+
+			if (outcomes[outcome]++ == 0 && outcome != FilterDesignSweep::outcomeOk)
+				firstFailure[outcome] = describeParams(filter, params);
+		}
+
+		int getNumFailures() const
+		{
+			return points - outcomes[FilterDesignSweep::outcomeOk];
+		}
+	};
+
+	void sweepDesign(int design, Dsp::Filter& filter, DesignStats& stats, int fuzzPoints, Random& random)
+	{
+		const int numParams = filter.getNumParams();
+		const Dsp::Params defaults = filter.getDefaultParams();
+		const int orderParam = findParam(filter, Dsp::idOrder);
+
+		for (int rate = 0; rate < numSweepSampleRates; ++rate)
+		{
+			Dsp::Params params = defaults;
+			params[0] = sweepSampleRates[rate];
+
+			// Every order with the other parameters at their defaults
+			if (orderParam >= 0)
+			{
+				for (int order = 1; order <= maxOrder; ++order)
+				{
+					params[orderParam] = order;
+					stats.add(design, filter, params);
+				}
+			}
+
+			// Each of the other parameters across its range, at the highest order
+			for (int i = 1; i < numParams; ++i)
+			{
+				if (i == orderParam)
+					continue;
+
+				Dsp::Params swept = params;
+				const Dsp::ParamInfo info = filter.getParamInfo(i);
+
+				if (orderParam >= 0)
+					swept[orderParam] = maxOrder;
+
+				for (int step = 0; step <= sweepSteps; ++step)
+				{
+					swept[i] = info.toNativeValue(step / (double) sweepSteps);
+					stats.add(design, filter, swept);
+				}
+			}
+		}
+
+		// Random combinations of all of them
+		for (int point = 0; point < fuzzPoints; ++point)
+		{
+			Dsp::Params params = defaults;
+			params[0] = sweepSampleRates[random.nextInt(numSweepSampleRates)];
+
+			for (int i = 1; i < numParams; ++i)
+				params[i] = filter.getParamInfo(i).toNativeValue(random.nextDouble());
+
+			stats.add(design, filter, params);
+		}
+	}
+
+	double getMedian(Array<double> values)
+	{
+		if (values.isEmpty())
+			return 0.0;
+
+		std::sort(values.begin(), values.end());
+		return values[values.size() / 2];
+	}
+
+	double getMaximum(const Array<double>& values)
+	{
+		double maximum = 0.0;
+
+		for (double value : values)
+			maximum = jmax(maximum, value);
+
+		return maximum;
+	}
+}
+
+const char* FilterDesignSweep::getOutcomeName(int outcome)
+{
+	jassert(outcome >= 0 && outcome < numOutcomes);
+	return outcomeNames[outcome];
+}
+
+int FilterDesignSweep::getNumDesigns()
+{
+	return numElementsInArray(designs);
+}
+
+Dsp::Filter* FilterDesignSweep::createDesign(int design)
+{
+	jassert(design >= 0 && design < getNumDesigns());
+	return designs[design]();
+}
+
+FilterDesignSweep::Outcome FilterDesignSweep::checkDesign(Dsp::Filter& filter, const Dsp::Params& params)
+{
+	try
+	{
+		filter.setParams(params);
+	}
+	catch (const std::exception&)
+	{
+		return outcomeThrew;
+	}
+
+	// Poles and zeros, digital ones being finite even where the analog prototype has
+	// zeros at infinity
+	double radius = 0.0;
+
+	for (const Dsp::PoleZeroPair& pair : filter.getPoleZeros())
+	{
+		if (!isFinite(pair.poles.first) || !isFinite(pair.poles.second)
+			|| !isFinite(pair.zeros.first) || !isFinite(pair.zeros.second))
+			return outcomeNaN;
+
+		radius = jmax(radius, std::abs(pair.poles.first), std::abs(pair.poles.second));
+	}
+
+	if (radius >= 1.0)
+		return outcomeUnstable;
+
+	// Noise through the cascade as it will really run, which also catches coefficients
+	// that are finite but lose the poles' stability to rounding
+	double probe[probeLength];
+	double* channels[1] = { probe };
+	Random random(1);
+
+	for (int i = 0; i < probeLength; ++i)
+		probe[i] = random.nextDouble() * 2.0 - 1.0;
+
+	filter.reset();
+	filter.process(probeLength, channels);
+
+	for (int i = 0; i < probeLength; ++i)
+	{
+		if (!std::isfinite(probe[i]))
+			return outcomeNaN;
+
+		if (std::abs(probe[i]) > blowUpLevel)
+			return outcomeBlowUp;
+	}
+
+	return radius > marginalRadius ? outcomeMarginal : outcomeOk;
+}
+
+double FilterDesignSweep::measureSetup(int design, const Dsp::Params& params, bool isCold)
+{
+	double runSeconds[setupRuns];
+
+	for (int run = 0; run < setupRuns; ++run)
+	{
+		Dsp::PrototypeCache::clear();
+
+		if (! isCold)
+		{
+			ScopedPointer<Dsp::Filter> warmUp = createDesign(design);
+			setParamsIgnoringErrors(*warmUp, params);
+		}
+
+		// A new filter every run, as a filter doesn't redesign the prototype it already has
+		ScopedPointer<Dsp::Filter> filter = createDesign(design);
+
+		const Clock::time_point start = Clock::now();
+		setParamsIgnoringErrors(*filter, params);
+		runSeconds[run] = getSecondsSince(start);
+	}
+
+	std::sort(runSeconds, runSeconds + setupRuns);
+	return runSeconds[setupRuns / 2];
+}
+
+double FilterDesignSweep::measureThroughput(Dsp::Filter& filter, double sampleRate, int numSamples)
+{
+	Dsp::Params params = filter.getDefaultParams();
+	params[0] = sampleRate;
+
+	const int orderParam = findParam(filter, Dsp::idOrder);
+
+	if (orderParam >= 0)
+		params[orderParam] = maxOrder;
+
+	filter.setParams(params);
+
+	// Noise in blocks of a typical host size
+	const int blockSize = 512;
+	AudioBuffer<float> input(1, blockSize);
+	AudioBuffer<float> block(1, blockSize);
+	Random random(1);
+
+	for (int i = 0; i < blockSize; ++i)
+		input.setSample(0, i, random.nextFloat() * 2.0f - 1.0f);
+
+	// Keep the fastest of a few runs, which is the least disturbed by the rest of the system
+	double bestSeconds = std::numeric_limits<double>::max();
+
+	for (int run = 0; run < 5; ++run)
+	{
+		filter.reset();
+		double seconds = 0.0;
+
+		for (int done = 0; done < numSamples; done += blockSize)
+		{
+			block.makeCopyOf(input, true);
+
+			const Clock::time_point start = Clock::now();
+			filter.process(blockSize, block.getArrayOfWritePointers());
+			seconds += getSecondsSince(start);
+		}
+
+		bestSeconds = jmin(bestSeconds, seconds);
+	}
+
+	const int numBlocks = (numSamples + blockSize - 1) / blockSize;
+	return bestSeconds * 1.0e9 / (numBlocks * blockSize);
+}
+
+String FilterDesignSweep::runSweep(int fuzzPointsPerDesign, double setupBudgetMicroseconds)
+{
+	String report;
+	report << "Filter design sweep, orders up to " << maxOrder << ", " << numSweepSampleRates
+		<< " sample rates, " << fuzzPointsPerDesign << " fuzzed points per design" << newLine
+		<< "Setup of a new filter in microseconds, the median of " << setupRuns << " runs at each point, "
+		<< "with the prototype cache cleared (cold) and holding the prototype (cached)" << newLine
+		<< "Throughput in ns per sample at the highest order, "
+		<< "realtime if every point passed and cold setup stayed under " << String(setupBudgetMicroseconds, 1)
+		<< " us" << newLine << newLine;
+
+	report << String("design").paddedRight(' ', 26)
+		<< String("points").paddedLeft(' ', 7)
+		<< String("cold med").paddedLeft(' ', 10)
+		<< String("cold max").paddedLeft(' ', 10)
+		<< String("cached med").paddedLeft(' ', 12)
+		<< String("cached max").paddedLeft(' ', 12)
+		<< String("ns/smp").paddedLeft(' ', 8);
+
+	for (int outcome = outcomeMarginal; outcome < numOutcomes; ++outcome)
+		report << String(outcomeNames[outcome]).paddedLeft(' ', 9);
+
+	report << String("realtime").paddedLeft(' ', 10) << newLine;
+
+	String failures;
+	Random random(1);
+
+	for (int design = 0; design < getNumDesigns(); ++design)
+	{
+		ScopedPointer<Dsp::Filter> filter = createDesign(design);
+		const String name(filter->getName());
+
+		DesignStats stats;
+		sweepDesign(design, *filter, stats, fuzzPointsPerDesign, random);
+
+		const double maximumColdSetup = getMaximum(stats.coldSetupSeconds) * 1.0e6;
+		const bool isRealtime = stats.getNumFailures() == 0 && maximumColdSetup <= setupBudgetMicroseconds;
+
+		report << name.paddedRight(' ', 26)
+			<< String(stats.points).paddedLeft(' ', 7)
+			<< String(getMedian(stats.coldSetupSeconds) * 1.0e6, 2).paddedLeft(' ', 10)
+			<< String(maximumColdSetup, 2).paddedLeft(' ', 10)
+			<< String(getMedian(stats.cachedSetupSeconds) * 1.0e6, 2).paddedLeft(' ', 12)
+			<< String(getMaximum(stats.cachedSetupSeconds) * 1.0e6, 2).paddedLeft(' ', 12)
+			<< String(measureThroughput(*filter, 48000.0, 48000), 2).paddedLeft(' ', 8);
+
+		for (int outcome = outcomeMarginal; outcome < numOutcomes; ++outcome)
+		{
+			report << String(stats.outcomes[outcome]).paddedLeft(' ', 9);
+
+			if (stats.outcomes[outcome] > 0)
+				failures << name << ", " << outcomeNames[outcome] << ": " << stats.firstFailure[outcome] << newLine;
+		}
+
+		report << String(isRealtime ? "yes" : "no").paddedLeft(' ', 10) << newLine;
+	}
+
+	if (failures.isNotEmpty())
+		report << newLine << "First failing point of each kind" << newLine << failures;
+
+	return report;
+}
@@ -0,0 +1,86 @@
+/*
+------------------------------------------------------------------------------
+
+Filter design sweep
+================
+Setup cost, throughput and robustness of every DSPFilters design.
+
+Before a design may be set up on the audio thread its worst case has to be
+known. The sweep walks each design over its orders and, one at a time, over
+the full range of every other parameter at several sample rates, then fuzzes
+it with random combinations of all of them. Every point is timed and checked
+for NaNs, poles on or outside the unit circle, poles so close to it that
+the cascade loses precision, output that blows up and designs that throw.
+
+Setup is timed twice at each point, each time on a new filter so that none
+of the designs' own memory of their last prototype is reused. Cold setup
+clears the shared Dsp::PrototypeCache first, so the analog prototype is
+designed from scratch. Cached setup designs it once beforehand, so it is
+only looked up, as the plugin's crossover does after preparing.
+
+The ranges are the ones the designs advertise through Dsp::ParamInfo, which
+are what automation or a GUI would produce. The library asserts on some bad
+designs, so the sweep is meant for release builds, where those are counted
+instead. It is built into the AirDesignSweep tool, not the plugin.
+
+By Daniel Rothmann
+
+Provided under GNU General Public license:
+http://www.gnu.org/licenses/
+
+------------------------------------------------------------------------------
+*/
+
+#ifndef FILTERDESIGNSWEEP_H_INCLUDED
+#define FILTERDESIGNSWEEP_H_INCLUDED
+
+#include "../JuceLibraryCode/JuceHeader.h"
+#include "DspFilters/Dsp.h"
+
+namespace FilterDesignSweep
+{
+	// Highest order the designs are instantiated with
+	const int maxOrder = 16;
+
+	// Pole radius above which a stable design counts as marginal
+	const double marginalRadius = 1.0 - 1.0e-6;
+
+	// Times each setup is repeated, of which the median is kept
+	const int setupRuns = 5;
+
+	enum Outcome
+	{
+		outcomeOk = 0,
+		outcomeMarginal,
+		outcomeUnstable,
+		outcomeNaN,
+		outcomeBlowUp,
+		outcomeThrew,
+		numOutcomes
+	};
+
+	const char* getOutcomeName(int outcome);
+
+	int getNumDesigns();
+
+	// Create a design with one channel of state (allocates, not for the audio thread)
+	Dsp::Filter* createDesign(int design);
+
+	// Set the parameters and classify the result
+	Outcome checkDesign(Dsp::Filter& filter, const Dsp::Params& params);
+
+	// Time setting the parameters of a new filter of the design, in seconds, with
+	// the prototype cache cleared beforehand or already holding the prototype
+	// (clears the cache, so not while filters are set up elsewhere)
+	double measureSetup(int design, const Dsp::Params& params, bool isCold);
+
+	// Time processing at the design's defaults and highest order, returning nanoseconds per sample
+	double measureThroughput(Dsp::Filter& filter, double sampleRate, int numSamples);
+
+	// Sweep and fuzz every design as a report, marking those whose every point passed
+	// and whose slowest cold setup stayed within the budget as fit for the audio thread
+	// (not realtime safe, takes seconds)
+	String runSweep(int fuzzPointsPerDesign, double setupBudgetMicroseconds);
+}
+
+#endif  // FILTERDESIGNSWEEP_H_INCLUDED
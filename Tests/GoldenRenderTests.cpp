@@ -0,0 +1,461 @@
+/*
+------------------------------------------------------------------------------
+
+Golden render tests
+================
+Renders a fixed corpus of signals through AirAudioProcessor, at a grid of
+settings around the defaults, and compares every render with a stored
+reference in Tests/References.
+
+The corpus is rendered once with each instruction set the machine supports,
+forced through CpuDispatch. The references are rendered with the reference
+C++ kernels, on x86-64 Linux, so with those kernels every render must match
+bit for bit; other platforms may round the filter designs differently. With
+the vector kernels each case has its own tolerance. Cases whose processing
+rounds the same way on every set must still match exactly. Those that run
+the waveshaper curve through the reciprocal estimate kernels are held to a
+bound on their peak error instead.
+
+Usage: AirGoldenTests <reference folder> [--update]
+
+With --update the references are written afresh instead of compared, which
+is only for after a change that is meant to alter the sound.
+
+By Daniel Rothmann
+
+Provided under GNU General Public license:
+http://www.gnu.org/licenses/
+
+------------------------------------------------------------------------------
+*/
+
+#include "../Source/PluginProcessor.h"
+#include <cstdio>
+#include <functional>
+#include <limits>
+
+namespace
+{
+	const double sampleRate = 44100.0;
+	const int signalLength = 8192;
+
+	// Host block size for most cases, not a multiple of the internal chunk size
+	const int hostBlockSize = 1000;
+
+	// Tolerance of the cases that must match their reference exactly
+	const double bitExact = -std::numeric_limits<double>::infinity();
+
+	// Peak error allowed where the waveshaper's kernels round differently, in dB of full scale
+	const double kernelRoundingBound = -110.0;
+
+	//==============================================================================
+	// Test signals
+
+	enum Signal
+	{
+		signalSweep = 0,
+		signalNoise,
+		signalImpulses,
+		signalTransients,
+		numSignals
+	};
+
+	const char* const signalNames[numSignals] = { "sweep", "noise", "impulses", "transients" };
+
+	void generateSignal(int signal, AudioSampleBuffer& buffer)
+	{
+		buffer.setSize(2, signalLength);
+		buffer.clear();
+
+		Random random(0x414952 + signal);
+
+		switch (signal)
+		{
+			case signalSweep:
+			{
+				// Logarithmic sine sweep from 20 Hz to 20 kHz, quieter on the right
+				const double startFreq = 20.0;
+				const double rate = log(20000.0 / startFreq) / signalLength;
+
+				for (int i = 0; i < signalLength; ++i)
+				{
+					const double phase = 2.0 * double_Pi * startFreq * (exp(rate * i) - 1.0) / (rate * sampleRate);
+					buffer.setSample(0, i, (float) (0.5 * sin(phase)));
+					buffer.setSample(1, i, (float) (0.25 * sin(phase)));
+				}
+
+				break;
+			}
+
+			case signalNoise:
+			{
+				// Uncorrelated white noise at -6 dBFS peak
+				for (int channel = 0; channel < 2; ++channel)
+					for (int i = 0; i < signalLength; ++i)
+						buffer.setSample(channel, i, 0.5f * (2.0f * random.nextFloat() - 1.0f));
+
+				break;
+			}
+
+			case signalImpulses:
+			{
+				// Impulses of falling level and alternating sign, offset between the channels
+				const int spacing = 1024;
+
+				for (int i = 0; i < signalLength / spacing; ++i)
+				{
+					const float level = ((i & 1) != 0 ? -1.0f : 1.0f) / (float) (1 << (i % 4));
+					buffer.setSample(0, i * spacing, level);
+					buffer.setSample(1, i * spacing + spacing / 2, level);
+				}
+
+				break;
+			}
+
+			case signalTransients:
+			{
+				// Sharply decaying bursts of noise and a bright tone, alternately loud and soft
+				const int spacing = 2048;
+				const double decay = exp(-1.0 / (0.005 * sampleRate));
+
+				for (int channel = 0; channel < 2; ++channel)
+				{
+					double envelope = 0.0;
+
+					for (int i = 0; i < signalLength; ++i)
+					{
+						if (i % spacing == channel * 64)
+							envelope = ((i / spacing) & 1) != 0 ? 0.3 : 1.0;
+
+						const double tone = sin(2.0 * double_Pi * 6000.0 * i / sampleRate);
+						const double noise = 2.0 * random.nextDouble() - 1.0;
+
+						buffer.setSample(channel, i, (float) (envelope * (0.6 * noise + 0.4 * tone)));
+						envelope *= decay;
+					}
+				}
+
+				break;
+			}
+
+			default:
+				jassertfalse;
+				break;
+		}
+	}
+
+	//==============================================================================
+	// Cases, each rendered with every signal
+
+	struct Case
+	{
+		const char* name;
+
+		// Parameter values
+		float crossFreq;
+		float threshold;
+		float airAmt;
+		float dryWet;
+		float hpGain;
+
+		double tolerance;
+
+		// Settings that aren't parameters, made before preparing
+		std::function<void(AirAudioProcessor&)> setUp;
+
+		int blockSize;
+
+		// Frequency the crossover moves to by the end of the render, or 0 to keep it still
+		float crossFreqEnd;
+	};
+
+	std::vector<Case> createCases()
+	{
+		const float crossFreq = 4000.0f;
+		const float threshold = -18.0f;
+		const float airAmt = 0.5f;
+		const float dryWet = 0.6f;
+		const float hpGain = 1.0f;
+
+		const std::function<void(AirAudioProcessor&)> defaults;
+
+		return
+		{
+			// Every parameter at the middle of the grid, then each one at either end of its range
+			{ "default",         crossFreq, threshold, airAmt, dryWet, hpGain, kernelRoundingBound, defaults, hostBlockSize, 0.0f },
+			{ "crossFreqLow",    1000.0f,   threshold, airAmt, dryWet, hpGain, kernelRoundingBound, defaults, hostBlockSize, 0.0f },
+			{ "crossFreqHigh",   8000.0f,   threshold, airAmt, dryWet, hpGain, kernelRoundingBound, defaults, hostBlockSize, 0.0f },
+			{ "thresholdLow",    crossFreq, -40.0f,    airAmt, dryWet, hpGain, kernelRoundingBound, defaults, hostBlockSize, 0.0f },
+			{ "thresholdHigh",   crossFreq, 0.0f,      airAmt, dryWet, hpGain, kernelRoundingBound, defaults, hostBlockSize, 0.0f },
+			{ "airOff",          crossFreq, threshold, 0.0f,   dryWet, hpGain, bitExact,            defaults, hostBlockSize, 0.0f },
+			{ "airFull",         crossFreq, threshold, 1.0f,   dryWet, hpGain, kernelRoundingBound, defaults, hostBlockSize, 0.0f },
+			{ "dry",             crossFreq, threshold, airAmt, 0.0f,   hpGain, bitExact,            defaults, hostBlockSize, 0.0f },
+			{ "wet",             crossFreq, threshold, airAmt, 1.0f,   hpGain, kernelRoundingBound, defaults, hostBlockSize, 0.0f },
+			{ "hpGainLow",       crossFreq, threshold, airAmt, dryWet, 0.25f,  kernelRoundingBound, defaults, hostBlockSize, 0.0f },
+			{ "hpGainHigh",      crossFreq, threshold, airAmt, dryWet, 2.0f,   kernelRoundingBound, defaults, hostBlockSize, 0.0f },
+
+			// The modes that aren't parameters, at the middle of the grid
+			{ "fiveBands", crossFreq, threshold, airAmt, dryWet, hpGain, kernelRoundingBound,
+			  [](AirAudioProcessor& processor) { *processor.numBands = AirAudioProcessor::maxBands; },
+			  hostBlockSize, 0.0f },
+
+			{ "linearPhase", crossFreq, threshold, airAmt, dryWet, hpGain, kernelRoundingBound,
+			  [](AirAudioProcessor& processor) { processor.setCrossoverMode(AirAudioProcessor::crossoverLinearPhase); },
+			  hostBlockSize, 0.0f },
+
+			{ "elliptic", crossFreq, threshold, airAmt, dryWet, hpGain, kernelRoundingBound,
+			  [](AirAudioProcessor& processor) { processor.setCrossoverFilters(CrossoverFilters::familyElliptic, 4); },
+			  hostBlockSize, 0.0f },
+
+			{ "truePeak", crossFreq, threshold, airAmt, dryWet, hpGain, kernelRoundingBound,
+			  [](AirAudioProcessor& processor) { processor.setDetectorType(SideChain::detectorTruePeak); },
+			  hostBlockSize, 0.0f },
+
+			{ "envelopeRms", crossFreq, threshold, airAmt, dryWet, hpGain, kernelRoundingBound,
+			  [](AirAudioProcessor& processor) { processor.setDetectorType(SideChain::detectorEnvelopeRms); },
+			  hostBlockSize, 0.0f },
+
+			{ "antiderivative1", crossFreq, threshold, airAmt, dryWet, hpGain, bitExact,
+			  [](AirAudioProcessor& processor) { processor.setShaperMode(WaveShaper::modeAntiderivative1); },
+			  hostBlockSize, 0.0f },
+
+			{ "antiderivative2", crossFreq, threshold, airAmt, dryWet, hpGain, bitExact,
+			  [](AirAudioProcessor& processor) { processor.setShaperMode(WaveShaper::modeAntiderivative2); },
+			  hostBlockSize, 0.0f },
+
+			// The crossover moving under automation, and the whole signal as one block
+			{ "crossFreqSweep", 2000.0f, threshold, airAmt, dryWet, hpGain, kernelRoundingBound, defaults, hostBlockSize, 6000.0f },
+			{ "largeBlock", crossFreq, threshold, airAmt, dryWet, hpGain, kernelRoundingBound, defaults, signalLength, 0.0f }
+		};
+	}
+
+	//==============================================================================
+	// Render a signal through a freshly prepared processor, offline so that every design is synchronous
+	void render(const Case& testCase, AudioSampleBuffer& buffer)
+	{
+		AirAudioProcessor processor;
+		processor.setNonRealtime(true);
+		processor.setPlayConfigDetails(2, 2, sampleRate, testCase.blockSize);
+
+		*processor.crossFreq = testCase.crossFreq;
+		*processor.cThreshold = testCase.threshold;
+		*processor.airAmt = testCase.airAmt;
+		*processor.dryWet = testCase.dryWet;
+		*processor.hpGain = testCase.hpGain;
+
+		if (testCase.setUp)
+			testCase.setUp(processor);
+
+		processor.prepareToPlay(sampleRate, testCase.blockSize);
+
+		MidiBuffer midiMessages;
+
+		for (int start = 0; start < buffer.getNumSamples(); start += testCase.blockSize)
+		{
+			if (testCase.crossFreqEnd > 0.0f)
+				*processor.crossFreq = testCase.crossFreq + (testCase.crossFreqEnd - testCase.crossFreq) * start / buffer.getNumSamples();
+
+			AudioSampleBuffer block(buffer.getArrayOfWritePointers(), buffer.getNumChannels(), start,
+									jmin(testCase.blockSize, buffer.getNumSamples() - start));
+			processor.processBlock(block, midiMessages);
+		}
+
+		processor.releaseResources();
+	}
+
+	File getReferenceFile(const File& folder, const Case& testCase, int signal)
+	{
+		return folder.getChildFile(String(testCase.name) + "-" + signalNames[signal] + ".wav");
+	}
+
+	bool writeReference(const File& file, const AudioSampleBuffer& buffer)
+	{
+		file.deleteFile();
+
+		std::unique_ptr<FileOutputStream> stream(file.createOutputStream());
+
+		if (stream == nullptr)
+			return false;
+
+		// 32 bit float, so that the comparison can be exact
+		WavAudioFormat format;
+		std::unique_ptr<AudioFormatWriter> writer(format.createWriterFor(stream.get(), sampleRate, (unsigned int) buffer.getNumChannels(),
+																		 32, StringPairArray(), 0));
+		if (writer == nullptr)
+			return false;
+
+		stream.release();
+		return writer->writeFromAudioSampleBuffer(buffer, 0, buffer.getNumSamples());
+	}
+
+	bool readReference(const File& file, AudioSampleBuffer& buffer)
+	{
+		WavAudioFormat format;
+		std::unique_ptr<AudioFormatReader> reader(format.createReaderFor(file.createInputStream().release(), true));
+
+		if (reader == nullptr)
+			return false;
+
+		buffer.setSize((int) reader->numChannels, (int) reader->lengthInSamples);
+		reader->read(&buffer, 0, buffer.getNumSamples(), 0, true, true);
+		return true;
+	}
+
+	// Largest difference between two renders in dB of full scale, infinite if they don't line up
+	double getPeakErrorDb(const AudioSampleBuffer& rendered, const AudioSampleBuffer& reference)
+	{
+		if (rendered.getNumChannels() != reference.getNumChannels() || rendered.getNumSamples() != reference.getNumSamples())
+			return std::numeric_limits<double>::infinity();
+
+		double peakError = 0.0;
+
+		for (int channel = 0; channel < rendered.getNumChannels(); ++channel)
+		{
+			const float* renderedSamples = rendered.getReadPointer(channel);
+			const float* referenceSamples = reference.getReadPointer(channel);
+
+			for (int i = 0; i < rendered.getNumSamples(); ++i)
+			{
+				const double error = std::abs((double) renderedSamples[i] - (double) referenceSamples[i]);
+
+				// Catch NaN, which compares false with everything
+				if (! (error <= peakError))
+					peakError = std::isnan(error) ? std::numeric_limits<double>::infinity() : error;
+			}
+		}
+
+		return peakError > 0.0 ? 20.0 * log10(peakError) : bitExact;
+	}
+
+	String formatDb(double db)
+	{
+		if (db == bitExact)
+			return "exact";
+
+		if (db == std::numeric_limits<double>::infinity())
+			return "mismatched";
+
+		return String(db, 1) + " dB";
+	}
+
+	// Writes every reference afresh. Returns the number of failures.
+	int updateReferences(const std::vector<Case>& cases, const File& referenceFolder)
+	{
+		int numFailures = 0;
+
+		for (const Case& testCase : cases)
+		{
+			for (int signal = 0; signal < numSignals; ++signal)
+			{
+				const File referenceFile = getReferenceFile(referenceFolder, testCase, signal);
+
+				AudioSampleBuffer buffer;
+				generateSignal(signal, buffer);
+				render(testCase, buffer);
+
+				if (! writeReference(referenceFile, buffer))
+				{
+					printf("FAIL %s/%s: can't write %s\n", testCase.name, signalNames[signal], referenceFile.getFullPathName().toRawUTF8());
+					++numFailures;
+				}
+			}
+		}
+
+		return numFailures;
+	}
+
+	// Renders every case with the kernels of one instruction set and compares it with its
+	// reference. The references come from the reference kernels, so that set must match them
+	// exactly. Returns the number of failures.
+	int compareWithReferences(const std::vector<Case>& cases, const File& referenceFolder, Dsp::CpuDispatch::InstructionSet set)
+	{
+		const String setName = Dsp::CpuDispatch::getName(set);
+		int numFailures = 0;
+
+		for (const Case& testCase : cases)
+		{
+			const double tolerance = set == Dsp::CpuDispatch::generic ? bitExact : testCase.tolerance;
+
+			for (int signal = 0; signal < numSignals; ++signal)
+			{
+				const File referenceFile = getReferenceFile(referenceFolder, testCase, signal);
+				const String testName = setName + " " + testCase.name + "/" + signalNames[signal];
+
+				AudioSampleBuffer buffer;
+				generateSignal(signal, buffer);
+				render(testCase, buffer);
+
+				AudioSampleBuffer reference;
+
+				if (! readReference(referenceFile, reference))
+				{
+					printf("FAIL %s: no reference at %s\n", testName.toRawUTF8(), referenceFile.getFullPathName().toRawUTF8());
+					++numFailures;
+					continue;
+				}
+
+				const double errorDb = getPeakErrorDb(buffer, reference);
+				const bool passed = errorDb <= tolerance;
+
+				printf("%s %s: %s (allowed %s)\n", passed ? "pass" : "FAIL", testName.toRawUTF8(),
+					   formatDb(errorDb).toRawUTF8(), formatDb(tolerance).toRawUTF8());
+
+				if (! passed)
+					++numFailures;
+			}
+		}
+
+		return numFailures;
+	}
+}
+
+//==============================================================================
+int main(int argc, char* argv[])
+{
+	ScopedJuceInitialiser_GUI juceInitialiser;
+
+	if (argc < 2)
+	{
+		printf("Usage: AirGoldenTests <reference folder> [--update]\n");
+		return 2;
+	}
+
+	const File referenceFolder = File::getCurrentWorkingDirectory().getChildFile(argv[1]);
+	const bool isUpdating = argc > 2 && String(argv[2]) == "--update";
+	const std::vector<Case> cases = createCases();
+	const int numRenders = (int) cases.size() * numSignals;
+
+	if (isUpdating)
+	{
+		if (! referenceFolder.createDirectory())
+		{
+			printf("Can't create %s\n", referenceFolder.getFullPathName().toRawUTF8());
+			return 2;
+		}
+
+		// Write references with the reference kernels, so that they don't depend on the machine
+		Dsp::CpuDispatch::force(Dsp::CpuDispatch::generic);
+
+		const int numFailures = updateReferences(cases, referenceFolder);
+		printf("Wrote %d references to %s\n", numRenders - numFailures, referenceFolder.getFullPathName().toRawUTF8());
+		return numFailures == 0 ? 0 : 1;
+	}
+
+	// Every set this machine supports, each taking effect as the processor prepares
+	int numFailures = 0;
+	int numSets = 0;
+
+	for (int set = 0; set < Dsp::CpuDispatch::numInstructionSets; ++set)
+	{
+		if (! Dsp::CpuDispatch::force((Dsp::CpuDispatch::InstructionSet) set))
+			continue;
+
+		numFailures += compareWithReferences(cases, referenceFolder, (Dsp::CpuDispatch::InstructionSet) set);
+		++numSets;
+	}
+
+	Dsp::CpuDispatch::force(Dsp::CpuDispatch::numInstructionSets);
+
+	printf("%d of %d renders failed\n", numFailures, numRenders * numSets);
+	return numFailures == 0 ? 0 : 1;
+}
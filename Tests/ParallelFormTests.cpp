@@ -0,0 +1,207 @@
+/*
+------------------------------------------------------------------------------
+
+Parallel form tests
+================
+Expands cascades of the DSPFilters designs into Dsp::ParallelForm and checks
+that the expansion is accurate: its frequency response must stay close to the
+cascade's across the band, and its impulse response must match the one the
+cascade renders sample for sample.
+
+It also checks that cascades with repeated poles, which have no expansion
+into first order partial fractions, are rejected, while a cascade with
+distinct poles close together is still accepted.
+
+Usage: AirParallelFormTests
+
+By Daniel Rothmann
+
+Provided under GNU General Public license:
+http://www.gnu.org/licenses/
+
+------------------------------------------------------------------------------
+*/
+
+#include "../JuceLibraryCode/JuceHeader.h"
+#include "DspFilters/Dsp.h"
+#include <cmath>
+#include <cstdio>
+#include <functional>
+#include <vector>
+
+namespace
+{
+	const double sampleRate = 44100.0;
+	const int impulseLength = 4096;
+
+	// Largest response difference allowed, relative to the cascade's peak
+	const double responseBound = 1.0e-9;
+
+	// Largest impulse response difference allowed, relative to the cascade's peak sample
+	const double impulseBound = 1.0e-9;
+
+	//==============================================================================
+	// Designs to expand
+
+	struct Design
+	{
+		const char* name;
+		std::function<const Dsp::Cascade&()> setup;
+	};
+
+	Dsp::SimpleFilter<Dsp::Bessel::LowPass<2>, 1> bessel2;
+	Dsp::SimpleFilter<Dsp::Bessel::LowPass<4>, 1> bessel4;
+	Dsp::SimpleFilter<Dsp::Butterworth::LowPass<8>, 1> butterworth8;
+	Dsp::SimpleFilter<Dsp::Butterworth::HighPass<8>, 1> butterworthHigh8;
+	Dsp::SimpleFilter<Dsp::Elliptic::LowPass<4>, 1> elliptic4;
+	Dsp::SimpleFilter<Dsp::Elliptic::LowPass<7>, 1> elliptic7;
+
+	std::vector<Design> createDesigns()
+	{
+		return
+		{
+			{ "Bessel low pass 2",       []() -> const Dsp::Cascade& { bessel2.setup(2, sampleRate, 1000.0); return bessel2; } },
+			{ "Bessel low pass 4",       []() -> const Dsp::Cascade& { bessel4.setup(4, sampleRate, 1000.0); return bessel4; } },
+			{ "Butterworth low pass 8",  []() -> const Dsp::Cascade& { butterworth8.setup(8, sampleRate, 1000.0); return butterworth8; } },
+			{ "Butterworth high pass 8", []() -> const Dsp::Cascade& { butterworthHigh8.setup(8, sampleRate, 200.0); return butterworthHigh8; } },
+			{ "Elliptic low pass 4",     []() -> const Dsp::Cascade& { elliptic4.setup(4, sampleRate, 2000.0, 1.0, 1.0); return elliptic4; } },
+			{ "Elliptic low pass 7",     []() -> const Dsp::Cascade& { elliptic7.setup(7, sampleRate, 5000.0, 0.5, 2.0); return elliptic7; } }
+		};
+	}
+
+	// Largest difference between the impulse responses of the cascade and its
+	// parallel form, relative to the cascade's largest sample
+	template <class Filter>
+	double getImpulseError(Filter& filter, const Dsp::ParallelForm& parallelForm)
+	{
+		std::vector<double> cascadeImpulse(impulseLength, 0.0);
+		std::vector<double> parallelImpulse(impulseLength, 0.0);
+		cascadeImpulse[0] = 1.0;
+		parallelImpulse[0] = 1.0;
+
+		double* channels[] = { cascadeImpulse.data() };
+		filter.reset();
+		filter.process(impulseLength, channels);
+
+		Dsp::ParallelForm::State state;
+		parallelForm.process(impulseLength, parallelImpulse.data(), state);
+
+		double peak = 0.0;
+		double error = 0.0;
+
+		for (int i = 0; i < impulseLength; ++i)
+		{
+			peak = jmax(peak, std::abs(cascadeImpulse[i]));
+			error = jmax(error, std::abs(cascadeImpulse[i] - parallelImpulse[i]));
+		}
+
+		return error / peak;
+	}
+
+	// Impulse responses of each design, which need its concrete filter to render
+	double getImpulseError(int design, const Dsp::ParallelForm& parallelForm)
+	{
+		switch (design)
+		{
+		case 0:  return getImpulseError(bessel2, parallelForm);
+		case 1:  return getImpulseError(bessel4, parallelForm);
+		case 2:  return getImpulseError(butterworth8, parallelForm);
+		case 3:  return getImpulseError(butterworthHigh8, parallelForm);
+		case 4:  return getImpulseError(elliptic4, parallelForm);
+		default: return getImpulseError(elliptic7, parallelForm);
+		}
+	}
+
+	//==============================================================================
+	// Cascades built straight from their poles
+
+	struct PoleCascade : Dsp::Cascade, Dsp::CascadeStages<2>
+	{
+		PoleCascade(const Dsp::ComplexPair& first, const Dsp::ComplexPair& second)
+		{
+			setCascadeStorage(getCascadeStorage());
+
+			Dsp::LayoutBase layout = layoutStorage;
+			layout.add(first, Dsp::ComplexPair(-1.0, -1.0));
+			layout.add(second, Dsp::ComplexPair(-1.0, -1.0));
+			layout.setNormal(0.0, 1.0);
+			setLayout(layout);
+		}
+
+		Dsp::Layout<4> layoutStorage;
+	};
+
+	struct PoleCase
+	{
+		const char* name;
+		Dsp::ComplexPair first;
+		Dsp::ComplexPair second;
+		bool shouldExpand;
+	};
+
+	const Dsp::complex_t resonance = std::polar(0.95, 0.3);
+	const Dsp::complex_t nearResonance = std::polar(0.95, 0.3001);
+
+	std::vector<PoleCase> createPoleCases()
+	{
+		return
+		{
+			{ "repeated pole pair", Dsp::ComplexPair(resonance, std::conj(resonance)), Dsp::ComplexPair(resonance, std::conj(resonance)), false },
+			{ "double real pole",   Dsp::ComplexPair(0.9, 0.9), Dsp::ComplexPair(resonance, std::conj(resonance)), false },
+			{ "close pole pairs",   Dsp::ComplexPair(resonance, std::conj(resonance)), Dsp::ComplexPair(nearResonance, std::conj(nearResonance)), true }
+		};
+	}
+}
+
+//==============================================================================
+int main()
+{
+	int numFailures = 0;
+
+	const std::vector<Design> designs = createDesigns();
+
+	for (int i = 0; i < (int) designs.size(); ++i)
+	{
+		const Dsp::Cascade& cascade = designs[i].setup();
+
+		Dsp::ParallelForm parallelForm;
+
+		if (! parallelForm.setCascade(cascade))
+		{
+			printf("FAIL %s: not expanded\n", designs[i].name);
+			++numFailures;
+			continue;
+		}
+
+		const double responseError = parallelForm.getResponseError(cascade);
+		const double impulseError = getImpulseError(i, parallelForm);
+		const bool passed = responseError < responseBound && impulseError < impulseBound;
+
+		printf("%s %s: %d sections, response error %.3g, impulse error %.3g (allowed %.3g, %.3g)\n",
+			passed ? "pass" : "FAIL", designs[i].name, parallelForm.getNumSections(),
+			responseError, impulseError, responseBound, impulseBound);
+
+		if (! passed)
+			++numFailures;
+	}
+
+	for (const PoleCase& poleCase : createPoleCases())
+	{
+		const PoleCascade cascade(poleCase.first, poleCase.second);
+
+		Dsp::ParallelForm parallelForm;
+		const bool expanded = parallelForm.setCascade(cascade);
+		bool passed = expanded == poleCase.shouldExpand;
+
+		if (expanded)
+			passed = passed && parallelForm.getResponseError(cascade) < responseBound;
+
+		printf("%s %s: %s\n", passed ? "pass" : "FAIL", poleCase.name, expanded ? "expanded" : "rejected");
+
+		if (! passed)
+			++numFailures;
+	}
+
+	printf("%d failures\n", numFailures);
+	return numFailures == 0 ? 0 : 1;
+}
@@ -0,0 +1,143 @@
+/*
+------------------------------------------------------------------------------
+
+Realtime safety check
+================
+Runs AirAudioProcessor through RealtimeSafety::runAutomationMatrix in each of
+its modes, with the checks linked into this executable so that malloc, the
+aligned allocators and pthread mutexes are caught as well as operator new.
+
+It first makes sure that the checks catch a deliberate violation of each kind,
+so that a build where the interposition silently failed can't pass.
+
+Usage: AirRealtimeCheck
+
+By Daniel Rothmann
+
+Provided under GNU General Public license:
+http://www.gnu.org/licenses/
+
+------------------------------------------------------------------------------
+*/
+
+#include "../Source/PluginProcessor.h"
+#include <cstdio>
+#include <cstdlib>
+#include <functional>
+
+#if ! AIR_REALTIME_CHECKS
+ #error "The realtime check must be built with AIR_REALTIME_CHECKS=1"
+#endif
+
+namespace
+{
+	const double sampleRate = 44100.0;
+
+	//==============================================================================
+	// Deliberate violations, which the checks must catch
+
+	struct Violation
+	{
+		const char* name;
+		std::function<void()> commit;
+	};
+
+	// Keeps the compiler from eliding allocations whose results aren't used
+	void* volatile sink = nullptr;
+
+	std::vector<Violation> createViolations()
+	{
+		return
+		{
+			{ "operator new",   []() { int* p = new int(1); sink = p; delete p; } },
+			{ "malloc",         []() { sink = std::malloc(64); std::free(sink); } },
+			{ "calloc",         []() { sink = std::calloc(4, 16); std::free(sink); } },
+			{ "posix_memalign", []() { void* p = nullptr; if (posix_memalign(&p, 64, 64) == 0) { sink = p; std::free(p); } } },
+		   #if JUCE_LINUX
+			{ "aligned_alloc",  []() { sink = aligned_alloc(64, 64); std::free(sink); } },
+		   #endif
+		   #if defined (__cpp_aligned_new)
+			{ "aligned new",    []() { sink = ::operator new(64, std::align_val_t(64)); ::operator delete(sink, std::align_val_t(64)); } },
+		   #endif
+			{ "mutex lock",     []() { static CriticalSection lock; const ScopedLock sl(lock); } }
+		};
+	}
+
+	// Returns the number of violations that went unnoticed
+	int checkViolationsAreCaught()
+	{
+		int numMissed = 0;
+
+		for (const Violation& violation : createViolations())
+		{
+			RealtimeSafety::clearViolations();
+
+			{
+				RealtimeSafety::ScopedAudioThread audioThread;
+				violation.commit();
+			}
+
+			const bool caught = RealtimeSafety::getNumViolations() > 0;
+			printf("%s self test %s\n", caught ? "pass" : "FAIL", violation.name);
+
+			if (! caught)
+				++numMissed;
+		}
+
+		RealtimeSafety::clearViolations();
+		return numMissed;
+	}
+
+	//==============================================================================
+	// Processor configurations, each of which gets the full automation matrix
+
+	struct Configuration
+	{
+		const char* name;
+		std::function<void(AirAudioProcessor&)> setUp;
+	};
+
+	std::vector<Configuration> createConfigurations()
+	{
+		return
+		{
+			{ "default",         [](AirAudioProcessor&) {} },
+			{ "linearPhase",     [](AirAudioProcessor& processor) { processor.setCrossoverMode(AirAudioProcessor::crossoverLinearPhase); } },
+			{ "elliptic",        [](AirAudioProcessor& processor) { processor.setCrossoverFilters(CrossoverFilters::familyElliptic, 4); } },
+			{ "antiderivative1", [](AirAudioProcessor& processor) { processor.setShaperMode(WaveShaper::modeAntiderivative1); } },
+			{ "antiderivative2", [](AirAudioProcessor& processor) { processor.setShaperMode(WaveShaper::modeAntiderivative2); } },
+			{ "truePeak",        [](AirAudioProcessor& processor) { processor.setDetectorType(SideChain::detectorTruePeak); } },
+			{ "envelopePeak",    [](AirAudioProcessor& processor) { processor.setDetectorType(SideChain::detectorEnvelopePeak); } },
+			{ "envelopeRms",     [](AirAudioProcessor& processor) { processor.setDetectorType(SideChain::detectorEnvelopeRms); } }
+		};
+	}
+}
+
+//==============================================================================
+int main()
+{
+	ScopedJuceInitialiser_GUI juceInitialiser;
+
+	int numFailures = checkViolationsAreCaught();
+
+	for (const Configuration& configuration : createConfigurations())
+	{
+		AirAudioProcessor processor;
+		configuration.setUp(processor);
+
+		const String report = RealtimeSafety::runAutomationMatrix(processor, sampleRate);
+
+		if (report.isEmpty())
+		{
+			printf("pass %s\n", configuration.name);
+		}
+		else
+		{
+			printf("FAIL %s:\n%s\n", configuration.name, report.toRawUTF8());
+			++numFailures;
+		}
+	}
+
+	printf("%d failures\n", numFailures);
+	return numFailures == 0 ? 0 : 1;
+}
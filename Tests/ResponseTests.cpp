@@ -0,0 +1,213 @@
+/*
+------------------------------------------------------------------------------
+
+Response tests
+================
+Checks the batch response(), magnitudeResponse() and groupDelay() of the
+DSPFilters cascades and biquads, which evaluate many frequencies at once,
+against the scalar response() at each of the same frequencies. The group
+delay is checked against a central difference of the scalar response's
+phase instead.
+
+Each filter is evaluated on uniform grids, whose sines and cosines come from
+a recurrence across many chunks, and on a logarithmic grid and a few short
+ones, which are evaluated point by point.
+
+Usage: AirResponseTests
+
+By Daniel Rothmann
+
+Provided under GNU General Public license:
+http://www.gnu.org/licenses/
+
+------------------------------------------------------------------------------
+*/
+
+#include "../JuceLibraryCode/JuceHeader.h"
+#include "DspFilters/Dsp.h"
+#include <cmath>
+#include <cstdio>
+#include <functional>
+#include <limits>
+#include <vector>
+
+namespace
+{
+	const double sampleRate = 44100.0;
+
+	// Largest response and magnitude difference allowed, relative to the filter's peak
+	const double responseBound = 1.0e-10;
+
+	// Largest group delay difference allowed, relative to the delay where it exceeds a sample
+	const double groupDelayBound = 1.0e-5;
+
+	// Half the step of the phase difference, in normalized frequency
+	const double phaseStep = 1.0e-6;
+
+	// Frequencies where the response is this far below the peak have no meaningful
+	// phase, and are left out of the group delay check
+	const double groupDelayFloor = 1.0e-6;
+
+	//==============================================================================
+	// Frequency grids
+
+	struct FrequencyGrid
+	{
+		const char* name;
+		std::vector<double> frequencies;
+	};
+
+	std::vector<double> createUniformGrid(int numFrequencies, double first, double last)
+	{
+		std::vector<double> frequencies;
+
+		for (int i = 0; i < numFrequencies; ++i)
+			frequencies.push_back(first + (last - first) * i / (numFrequencies - 1));
+
+		return frequencies;
+	}
+
+	std::vector<double> createLogGrid(int numFrequencies, double first, double last)
+	{
+		std::vector<double> frequencies;
+
+		for (int i = 0; i < numFrequencies; ++i)
+			frequencies.push_back(first * std::pow(last / first, (double) i / (numFrequencies - 1)));
+
+		return frequencies;
+	}
+
+	std::vector<FrequencyGrid> createGrids()
+	{
+		return
+		{
+			{ "uniform 1001",  createUniformGrid(1001, 0.0, 0.5) },
+			{ "uniform 4099",  createUniformGrid(4099, 0.001, 0.499) },
+			{ "log 300",       createLogGrid(300, 1.0e-4, 0.49) },
+			{ "three points",  { 0.01, 0.02, 0.2 } },
+			{ "one point",     { 0.0227 } }
+		};
+	}
+
+	//==============================================================================
+	// Filters to evaluate
+
+	Dsp::SimpleFilter<Dsp::Bessel::LowPass<4>, 1> bessel4;
+	Dsp::SimpleFilter<Dsp::Butterworth::LowPass<8>, 1> butterworth8;
+	Dsp::SimpleFilter<Dsp::ChebyshevI::BandPass<4>, 1> chebyshevBand4;
+	Dsp::SimpleFilter<Dsp::Elliptic::LowPass<7>, 1> elliptic7;
+	Dsp::SimpleFilter<Dsp::Butterworth::LowShelf<4>, 1> butterworthShelf4;
+	Dsp::RBJ::LowPass rbjLowPass;
+
+	struct ResponseErrors
+	{
+		double responseError;
+		double magnitudeError;
+		double groupDelayError;
+	};
+
+	// Differences between the batch and the scalar evaluations of one filter on one grid
+	template <class Filter>
+	ResponseErrors evaluate(const Filter& filter, const std::vector<double>& frequencies)
+	{
+		const int numFrequencies = (int) frequencies.size();
+
+		std::vector<Dsp::complex_t> responses(numFrequencies);
+		std::vector<double> magnitudes(numFrequencies);
+		std::vector<double> groupDelays(numFrequencies);
+
+		filter.response(frequencies.data(), responses.data(), numFrequencies);
+		filter.magnitudeResponse(frequencies.data(), magnitudes.data(), numFrequencies);
+		filter.groupDelay(frequencies.data(), groupDelays.data(), numFrequencies);
+
+		// The peak is taken on a fine grid of its own, so that short grids are not
+		// held to the response at their few points
+		double peak = 0.0;
+
+		for (double f : createUniformGrid(2001, 0.0, 0.5))
+			peak = jmax(peak, std::abs(filter.response(f)));
+
+		ResponseErrors result = { 0.0, 0.0, 0.0 };
+
+		for (int i = 0; i < numFrequencies; ++i)
+		{
+			const double f = frequencies[i];
+			const Dsp::complex_t expected = filter.response(f);
+
+			result.responseError = jmax(result.responseError, std::abs(responses[i] - expected) / peak);
+			result.magnitudeError = jmax(result.magnitudeError, std::abs(magnitudes[i] - std::abs(expected)) / peak);
+
+			if (std::abs(expected) < groupDelayFloor * peak)
+				continue;
+
+			// The phase difference is taken from the ratio of the two responses, which
+			// needs no unwrapping
+			const Dsp::complex_t ratio = filter.response(f + phaseStep) * std::conj(filter.response(f - phaseStep));
+			const double expectedDelay = -std::arg(ratio) / (2.0 * double_Pi * 2.0 * phaseStep);
+
+			const double error = std::isfinite(groupDelays[i])
+				? std::abs(groupDelays[i] - expectedDelay) / jmax(1.0, std::abs(expectedDelay))
+				: std::numeric_limits<double>::infinity();
+
+			result.groupDelayError = jmax(result.groupDelayError, error);
+		}
+
+		return result;
+	}
+
+	struct Design
+	{
+		const char* name;
+		std::function<ResponseErrors(const std::vector<double>&)> evaluate;
+	};
+
+	std::vector<Design> createDesigns()
+	{
+		bessel4.setup(4, sampleRate, 1000.0);
+		butterworth8.setup(8, sampleRate, 200.0);
+		chebyshevBand4.setup(4, sampleRate, 3000.0, 500.0, 1.0);
+		elliptic7.setup(7, sampleRate, 5000.0, 0.5, 2.0);
+		butterworthShelf4.setup(4, sampleRate, 300.0, 12.0);
+		rbjLowPass.setup(sampleRate, 1000.0, 4.0);
+
+		return
+		{
+			{ "Bessel low pass 4",       [](const std::vector<double>& f) { return evaluate<Dsp::Cascade>(bessel4, f); } },
+			{ "Butterworth low pass 8",  [](const std::vector<double>& f) { return evaluate<Dsp::Cascade>(butterworth8, f); } },
+			{ "Chebyshev I band pass 4", [](const std::vector<double>& f) { return evaluate<Dsp::Cascade>(chebyshevBand4, f); } },
+			{ "Elliptic low pass 7",     [](const std::vector<double>& f) { return evaluate<Dsp::Cascade>(elliptic7, f); } },
+			{ "Butterworth low shelf 4", [](const std::vector<double>& f) { return evaluate<Dsp::Cascade>(butterworthShelf4, f); } },
+			{ "RBJ low pass biquad",     [](const std::vector<double>& f) { return evaluate<Dsp::BiquadBase>(rbjLowPass, f); } }
+		};
+	}
+}
+
+//==============================================================================
+int main()
+{
+	int numFailures = 0;
+
+	const std::vector<FrequencyGrid> grids = createGrids();
+
+	for (const Design& design : createDesigns())
+	{
+		for (const FrequencyGrid& grid : grids)
+		{
+			const ResponseErrors result = design.evaluate(grid.frequencies);
+			const bool passed = result.responseError < responseBound
+				&& result.magnitudeError < responseBound
+				&& result.groupDelayError < groupDelayBound;
+
+			printf("%s %s, %s: response %.3g, magnitude %.3g, group delay %.3g (allowed %.3g, %.3g)\n",
+				passed ? "pass" : "FAIL", design.name, grid.name,
+				result.responseError, result.magnitudeError, result.groupDelayError,
+				responseBound, groupDelayBound);
+
+			if (! passed)
+				++numFailures;
+		}
+	}
+
+	printf("%d failures\n", numFailures);
+	return numFailures == 0 ? 0 : 1;
+}